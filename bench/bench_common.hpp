@@ -0,0 +1,51 @@
+// bench_common.hpp
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// Shared helpers for the bench/ programs. Each bench is a plain executable
+// that prints one line per case; run them all with `make run-bench`.
+
+namespace bench {
+
+    inline uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // q in [0, 1]; sorts samples
+    inline uint64_t percentile(std::vector<uint64_t>& samples, double q) {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        std::size_t i = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+        return samples[i];
+    }
+
+    // Cross-thread numbers mean little on one core; say so next to them
+    inline void printHost() {
+        std::printf("host: %u hardware threads\n", std::thread::hardware_concurrency());
+    }
+
+    // Swallows the bus classes' logging when pointed to by std::cout or
+    // std::cerr. It keeps no state, so threads may log through it at once,
+    // which a std::ostringstream would not survive.
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    // Keep the optimizer from discarding a result
+    template <typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+} // namespace bench
@@ -0,0 +1,192 @@
+// bridge_bench.cpp
+//
+// Two BusBridges (bus/bus_bridge.hpp) over TCP loopback, each on its own
+// BusLoop thread, as two hosts' controllers would be:
+//
+//   ping-pong  one message at a time to the far bridge, which echoes it
+//              back; round-trip latency, so two bridge hops each way
+//   stream     the near bridge forwards STREAM_BURST messages per PACE_MS
+//              tick for PHASE; what the far bridge receives per second
+//
+// Each runs with batching off (every message its own send()) and with the
+// bridge's default 64-message / 500 us window. A bridge flushes after each
+// read pass, so a ping-pong never waits out the window; stream shows what
+// the window buys. STREAM_BURST is more than the near loop forwards in a
+// tick, so stream measures the bridge's ceiling. Both bridges share this
+// process's symbol table, so names resolve, but ids still go through the
+// announce-and-map path a second host would take.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/bus_bridge.hpp"
+#include "bus/bus_loop.hpp"
+#include "bus/symbol_table.hpp"
+
+namespace {
+
+    constexpr int PINGS = 5000;
+    constexpr int PACE_MS = 1;
+    constexpr int STREAM_BURST = 50000;
+    constexpr std::chrono::milliseconds PHASE{1000};
+    constexpr uint64_t PING_RETRY_NS = 100'000'000;     // A ping sent before the far side connected is lost
+
+    int nextPort = 47610;
+
+    // One side: a loop thread and its bridge
+    struct Side {
+        std::unique_ptr<BusLoop> loop = makeBusLoop(BusBackend::EPOLL);
+        std::unique_ptr<BusBridge> bridge;
+        std::thread thread;
+
+        Side(const char* name, bool listen, int port, SymbolId from, const BusLoop::BatchPolicy& batching) {
+            BusBridge::Config config;
+            config.name = name;
+            (listen ? config.listen : config.connect) = "127.0.0.1:" + std::to_string(port);
+            config.routes.push_back({ from, NO_SYMBOL });
+            config.batching = batching;
+            bridge = std::make_unique<BusBridge>(*loop, nullptr, config);
+        }
+
+        void start() {
+            thread = std::thread([this] { loop->run(); });
+        }
+
+        void stop() {
+            loop->stop();
+            thread.join();
+        }
+    };
+
+    void pingPong(const char* policyName, const BusLoop::BatchPolicy& batching) {
+        SymbolId ping = symbols().intern("bench_ping");
+        SymbolId pong = symbols().intern("bench_pong");
+        int port = nextPort++;
+        Side near("near", true, port, ping, batching);
+        Side far("far", false, port, pong, batching);
+
+        // Far side echoes everything back as a pong
+        BusBridge& farBridge = *far.bridge;
+        far.bridge->onRemote([&farBridge, ping, pong](const Message& msg) {
+            Message reply = msg;
+            reply.from = pong;
+            reply.to = ping;
+            farBridge.forward(reply);
+        });
+
+        std::vector<uint64_t> samples;
+        samples.reserve(PINGS);
+        std::atomic<bool> done{false};
+        uint64_t sentAt = 0;
+        Message msg = Message::make(ping, pong, ButtonPress{ ping, true });
+        BusBridge& nearBridge = *near.bridge;
+        auto send = [&] {
+            msg.seq++;
+            sentAt = bench::nowNs();
+            nearBridge.forward(msg);
+        };
+        near.bridge->onRemote([&](const Message& reply) {
+            if (reply.seq != msg.seq) {
+                return;     // Echo of a ping already retried
+            }
+            samples.push_back(bench::nowNs() - sentAt);
+            if (samples.size() < PINGS) {
+                send();
+            } else {
+                done.store(true);
+            }
+        });
+        // Starts the exchange once connected, and resends a lost ping
+        near.loop->addTimer(std::chrono::milliseconds(PACE_MS), [&](uint64_t) {
+            if (nearBridge.connected() && samples.size() < PINGS && bench::nowNs() - sentAt > PING_RETRY_NS) {
+                send();
+            }
+        });
+
+        near.start();
+        far.start();
+        uint64_t deadline = bench::nowNs() + 20'000'000'000ull;
+        while (!done.load() && bench::nowNs() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        near.stop();
+        far.stop();
+
+        std::printf("ping-pong  %-9s  round trip p50 %7.1f us  p99 %7.1f us  (%zu samples)\n", policyName,
+                    static_cast<double>(bench::percentile(samples, 0.5)) / 1000.0,
+                    static_cast<double>(bench::percentile(samples, 0.99)) / 1000.0, samples.size());
+    }
+
+    void stream(const char* policyName, const BusLoop::BatchPolicy& batching) {
+        SymbolId source = symbols().intern("bench_stream");
+        SymbolId sink = symbols().intern("bench_sink");
+        int port = nextPort++;
+        Side near("near", true, port, source, batching);
+        Side far("far", false, port, NO_SYMBOL, batching);
+
+        std::atomic<uint64_t> received{0};
+        far.bridge->onRemote([&received](const Message&) { received.fetch_add(1, std::memory_order_relaxed); });
+
+        Message msg = Message::make(source, sink, AnalogSample{ source, 0 });
+        BusBridge& nearBridge = *near.bridge;
+        near.loop->addTimer(std::chrono::milliseconds(PACE_MS), [&](uint64_t) {
+            if (!nearBridge.connected()) {
+                return;
+            }
+            for (int i = 0; i < STREAM_BURST; ++i) {
+                msg.seq++;
+                nearBridge.forward(msg);
+            }
+        });
+
+        near.start();
+        far.start();
+        uint64_t deadline = bench::nowNs() + 5'000'000'000ull;
+        while (received.load() == 0 && bench::nowNs() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        uint64_t before = received.load();
+        std::this_thread::sleep_for(PHASE);
+        uint64_t after = received.load();
+        near.stop();
+        far.stop();
+
+        const BusBridge::Stats& stats = near.bridge->stats();
+        std::printf("stream     %-9s  %9.0f msgs/s  %6.1f msgs/send  dropped %lu/%lu\n", policyName,
+                    static_cast<double>(after - before) / std::chrono::duration<double>(PHASE).count(),
+                    stats.flushes ? static_cast<double>(stats.forwarded) / static_cast<double>(stats.flushes) : 0.0,
+                    static_cast<unsigned long>(stats.dropped),
+                    static_cast<unsigned long>(stats.forwarded + stats.dropped));
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+
+    // Bridges log connects and disconnects from both loop threads
+    bench::NullBuffer discard;
+    std::streambuf* console = std::cout.rdbuf(&discard);
+    std::streambuf* errors = std::cerr.rdbuf(&discard);
+
+    const BusLoop::BatchPolicy unbatched{ 1, std::chrono::microseconds{0} };
+    const BusLoop::BatchPolicy window = BusBridge::Config{}.batching;
+    try {
+        pingPong("window 0", unbatched);
+        pingPong("500 us", window);
+        stream("window 0", unbatched);
+        stream("500 us", window);
+    } catch (const std::exception& e) {
+        std::printf("skipped: %s\n", e.what());
+    }
+
+    std::cout.rdbuf(console);
+    std::cerr.rdbuf(errors);
+    return 0;
+}
@@ -0,0 +1,145 @@
+// codec_bench.cpp
+//
+// Packet codecs (bus/bus_codec.hpp) on their own: BinaryCodec against the
+// arena-backed ProtobufCodec. Each pass encodes every message into its
+// packet slot, then decodes them back in bursts of BURST, calling
+// endBatch() after each as a transport does at the end of a receive burst.
+//
+// Heap allocations are counted through the replaced global operator new,
+// so "allocs/msg" is what either codec costs the allocator in steady
+// state. The protobuf row needs `make PROTOBUF=1`; without it only binary
+// runs.
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/bus_codec.hpp"
+#include "bus/message_registry.hpp"
+#include "bus/symbol_table.hpp"
+#ifdef FIDGET_WITH_PROTOBUF
+#include "bus/protobuf_codec.hpp"
+#endif
+
+namespace {
+
+    std::atomic<uint64_t> allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    constexpr std::size_t MESSAGES = 1 << 16;
+    constexpr std::size_t BURST = 64;
+    constexpr int PASSES = 20;
+
+    std::vector<Message> makeMessages() {
+        std::vector<SymbolId> names;
+        for (const char* name : { "phc_a", "phc_b", "main_controller", "phc_a:PB1", "phc_a:PB2", "phc_b:POT2" }) {
+            names.push_back(symbols().intern(name));
+        }
+        std::mt19937 rng(16);
+        std::vector<Message> messages;
+        messages.reserve(MESSAGES);
+        for (std::size_t i = 0; i < MESSAGES; ++i) {
+            SymbolId from = names[rng() % names.size()];
+            SymbolId to = names[rng() % names.size()];
+            SymbolId id = names[rng() % names.size()];
+            switch (rng() % 3) {
+            case 0:
+                messages.push_back(Message::make(from, to, ButtonPress{ id, (i & 1) != 0 }));
+                break;
+            case 1:
+                messages.push_back(Message::make(from, to, StateTransition{ static_cast<uint8_t>(rng() % 6) }));
+                break;
+            default:
+                messages.push_back(Message::make(from, to, AnalogSample{ id, static_cast<int32_t>(rng() % 2048) - 1024 }));
+                break;
+            }
+        }
+        return messages;
+    }
+
+    void run(const char* name, BusCodec& codec, const std::vector<Message>& messages) {
+        std::vector<uint8_t> packets(messages.size() * BusCodec::MAX_PACKET_SIZE);
+        std::vector<std::size_t> sizes(messages.size());
+        std::vector<Message> decoded(messages.size());
+        uint64_t encodeNs = 0;
+        uint64_t decodeNs = 0;
+        uint64_t allocs = 0;
+        std::size_t failed = 0;
+
+        for (int pass = 0; pass <= PASSES; ++pass) {     // Pass 0 warms up, and sizes the arenas
+            uint64_t allocsBefore = allocations.load(std::memory_order_relaxed);
+            uint64_t start = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                sizes[i] = codec.encode(messages[i], std::span(packets).subspan(i * BusCodec::MAX_PACKET_SIZE, BusCodec::MAX_PACKET_SIZE));
+            }
+            uint64_t middle = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                if (!codec.decode(std::span<const uint8_t>(packets).subspan(i * BusCodec::MAX_PACKET_SIZE, sizes[i]), decoded[i])) {
+                    ++failed;
+                }
+                if ((i + 1) % BURST == 0) {
+                    codec.endBatch();
+                }
+            }
+            codec.endBatch();
+            uint64_t end = bench::nowNs();
+            if (pass > 0) {
+                encodeNs += middle - start;
+                decodeNs += end - middle;
+                allocs += allocations.load(std::memory_order_relaxed) - allocsBefore;
+            }
+        }
+
+        // Protobuf does not carry seq; compare what both formats carry
+        std::size_t mismatched = 0;
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            bytes += sizes[i];
+            const Message& a = messages[i];
+            const Message& b = decoded[i];
+            if (a.type != b.type || a.to != b.to) {
+                ++mismatched;
+            }
+        }
+
+        double count = static_cast<double>(messages.size()) * PASSES;
+        std::printf("%-9s  encode %6.1f ns/msg  decode %6.1f ns/msg  round trip %6.1f ns/msg  %5.1f bytes/msg  %5.3f allocs/msg%s\n",
+                    name, static_cast<double>(encodeNs) / count, static_cast<double>(decodeNs) / count,
+                    static_cast<double>(encodeNs + decodeNs) / count,
+                    static_cast<double>(bytes) / static_cast<double>(messages.size()), static_cast<double>(allocs) / count,
+                    failed || mismatched ? "  MISMATCH" : "");
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+    std::vector<Message> messages = makeMessages();
+
+    BinaryCodec binary;
+    run("binary", binary, messages);
+#ifdef FIDGET_WITH_PROTOBUF
+    ProtobufCodec protobuf;
+    run("protobuf", protobuf, messages);
+#else
+    std::printf("protobuf   skipped; build with make PROTOBUF=1\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,151 @@
+// dispatch_bench.cpp
+//
+// Payload dispatch: the registry's generated dispatcher (message_registry.hpp)
+// against std::visit and a chain of holds_alternative checks over the
+// std::variant payload Message used to carry, plus a table of function
+// pointers indexed by tag. Each case sums one field per payload so the
+// handlers cannot be optimized away. The variant records carry the same
+// header as Message and are the same size, so only dispatch differs.
+//
+//   mixed   payload types in random order (branch predictor defeated)
+//   runs    the same type repeated, as one publisher's burst would be
+#include <array>
+#include <cstdio>
+#include <random>
+#include <variant>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/message_registry.hpp"
+
+namespace {
+
+    constexpr std::size_t MESSAGES = 1 << 20;
+    constexpr int PASSES = 40;
+
+    using VariantPayload = std::variant<ButtonPress, StateTransition, AnalogSample>;
+
+    struct VariantMessage {
+        VariantPayload payload;
+        SymbolId from = NO_SYMBOL;
+        SymbolId to = NO_SYMBOL;
+        uint32_t tick = 0;
+        uint32_t seq = 0;
+        uint64_t enqueueNs = 0;
+    };
+
+    static_assert(sizeof(VariantMessage) == sizeof(Message), "compare records of the same size");
+
+    // Function pointer per tag, the shape of a hand-built jump table
+    template <typename Visitor>
+    struct PointerTable {
+        using Fn = void (*)(Visitor&, const Message&);
+
+        template <typename T>
+        static void call(Visitor& visitor, const Message& msg) {
+            visitor(PayloadTraits<T>::get(msg));
+        }
+
+        static void ignore(Visitor&, const Message&) {}
+
+        static constexpr std::array<Fn, MESSAGE_TYPE_COUNT> table = {
+            &ignore, &call<ButtonPress>, &call<StateTransition>, &call<AnalogSample> };
+    };
+
+    std::vector<Message> makeMessages(bool mixed) {
+        std::mt19937 rng(11);
+        std::vector<Message> messages;
+        messages.reserve(MESSAGES);
+        for (std::size_t i = 0; i < MESSAGES; ++i) {
+            int kind = mixed ? static_cast<int>(rng() % 3) : static_cast<int>((i / 256) % 3);
+            uint16_t id = static_cast<uint16_t>(rng() % 64);
+            if (kind == 0) {
+                messages.push_back(Message::make(1, 2, ButtonPress{ id, (i & 1) != 0 }));
+            } else if (kind == 1) {
+                messages.push_back(Message::make(1, 2, StateTransition{ static_cast<uint8_t>(id % 6) }));
+            } else {
+                messages.push_back(Message::make(1, 2, AnalogSample{ id, static_cast<int32_t>(rng() % 1000) }));
+            }
+        }
+        return messages;
+    }
+
+    std::vector<VariantMessage> toVariants(const std::vector<Message>& messages) {
+        std::vector<VariantMessage> variants;
+        variants.reserve(messages.size());
+        for (const Message& msg : messages) {
+            dispatchMessage(msg, [&variants, &msg](const auto& payload) {
+                variants.push_back({ payload, msg.from, msg.to, msg.tick, msg.seq, msg.enqueueNs });
+            });
+        }
+        return variants;
+    }
+
+    template <typename F>
+    void time(const char* name, const char* order, F&& pass) {
+        uint64_t sum = 0;
+        pass(sum);  // Warm up
+        uint64_t start = bench::nowNs();
+        for (int i = 0; i < PASSES; ++i) {
+            pass(sum);
+        }
+        double ns = static_cast<double>(bench::nowNs() - start) / (static_cast<double>(MESSAGES) * PASSES);
+        bench::keep(sum);
+        std::printf("%-6s %-20s %5.2f ns/msg\n", order, name, ns);
+    }
+
+    void run(const char* order, bool mixed) {
+        std::vector<Message> messages = makeMessages(mixed);
+        std::vector<VariantMessage> variants = toVariants(messages);
+
+        time("registry dispatcher", order, [&messages](uint64_t& sum) {
+            auto dispatcher = makeDispatcher(
+                [&sum](const ButtonPress& press) { sum += press.button_id; },
+                [&sum](const StateTransition& transition) { sum += transition.phase; },
+                [&sum](const AnalogSample& sample) { sum += static_cast<uint64_t>(sample.value); });
+            for (const Message& msg : messages) {
+                dispatcher(msg);
+            }
+        });
+
+        time("function pointers", order, [&messages](uint64_t& sum) {
+            detail::Overloaded visitor{
+                [&sum](const ButtonPress& press) { sum += press.button_id; },
+                [&sum](const StateTransition& transition) { sum += transition.phase; },
+                [&sum](const AnalogSample& sample) { sum += static_cast<uint64_t>(sample.value); } };
+            using Table = PointerTable<decltype(visitor)>;
+            for (const Message& msg : messages) {
+                Table::table[static_cast<std::size_t>(msg.type)](visitor, msg);
+            }
+        });
+
+        time("std::visit", order, [&variants](uint64_t& sum) {
+            detail::Overloaded visitor{
+                [&sum](const ButtonPress& press) { sum += press.button_id; },
+                [&sum](const StateTransition& transition) { sum += transition.phase; },
+                [&sum](const AnalogSample& sample) { sum += static_cast<uint64_t>(sample.value); } };
+            for (const VariantMessage& msg : variants) {
+                std::visit(visitor, msg.payload);
+            }
+        });
+
+        time("holds_alternative", order, [&variants](uint64_t& sum) {
+            for (const VariantMessage& msg : variants) {
+                const VariantPayload& payload = msg.payload;
+                if (std::holds_alternative<ButtonPress>(payload)) {
+                    sum += std::get<ButtonPress>(payload).button_id;
+                } else if (std::holds_alternative<StateTransition>(payload)) {
+                    sum += std::get<StateTransition>(payload).phase;
+                } else if (std::holds_alternative<AnalogSample>(payload)) {
+                    sum += static_cast<uint64_t>(std::get<AnalogSample>(payload).value);
+                }
+            }
+        });
+    }
+
+} // namespace
+
+int main() {
+    run("mixed", true);
+    run("runs", false);
+    return 0;
+}
@@ -0,0 +1,340 @@
+// event_loop_bench.cpp
+//
+// Cost of N bus endpoints under each BusLoop backend (epoll and io_uring),
+// and against a PipeBusClient receive thread per endpoint, the model the
+// loops replaced. Each endpoint is a SOCK_SEQPACKET socket pair carrying
+// wire frames.
+//
+//   idle    no traffic; what the receivers cost just by existing
+//   loaded  a generator thread writes LOADED_RATE msg/s round-robin into
+//           the endpoints the receivers drain
+//   send    the loop sends SEND_RATE msg/s round-robin over the endpoints
+//           from a PACE_MS timer, flushing once per tick, while an epoll
+//           loop on another thread drains the other ends
+//
+// CPU and voluntary context switches (wakeups) are for the whole process,
+// less the generator thread's own; for send they include the reader.
+// syscalls/1k is the loop's own
+// Stats::syscalls per thousand messages received or sent; a receive thread
+// per endpoint keeps no such count. msgs/s is what was delivered over the
+// phase, so for idle and loaded it is bounded by the offered rate.
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench_common.hpp"
+#include "bus/bus_codec.hpp"
+#include "bus/bus_loop.hpp"
+#include "bus/message_types.hpp"
+#include "bus/pipe_bus_client.hpp"
+#include "bus/wire_format.hpp"
+
+namespace {
+
+    constexpr int LOADED_RATE = 20'000;
+    constexpr int PACE_MS = 1;                      // Generator batch interval
+    constexpr std::chrono::milliseconds PHASE{2000};
+    constexpr int SEND_RATE = 100'000;
+
+    // One end of a socket pair. Offers its codec like UdsClientTransport,
+    // so either loop reads and writes the socket directly.
+    class PairTransport : public BusTransport {
+    public:
+        explicit PairTransport(int fd) : fd(fd) {}
+        ~PairTransport() override { close(fd); }
+
+        bool send(const Message& msg) override {
+            uint8_t frame[MAX_FRAME_SIZE];
+            std::size_t size = encodeFrame(msg, frame);
+            return ::send(fd, frame, size, MSG_DONTWAIT) == static_cast<ssize_t>(size);
+        }
+
+        // One sendmmsg per batch, as UdsClientTransport does
+        std::size_t sendBatch(std::span<const Message> msgs) override {
+            constexpr std::size_t MAX = 64;
+            uint8_t frames[MAX][MAX_FRAME_SIZE];
+            iovec iovs[MAX];
+            mmsghdr headers[MAX];
+            std::size_t sent = 0;
+            while (sent < msgs.size()) {
+                std::size_t count = std::min(MAX, msgs.size() - sent);
+                for (std::size_t i = 0; i < count; ++i) {
+                    iovs[i] = { frames[i], encodeFrame(msgs[sent + i], frames[i]) };
+                    headers[i] = {};
+                    headers[i].msg_hdr.msg_iov = &iovs[i];
+                    headers[i].msg_hdr.msg_iovlen = 1;
+                }
+                int n = sendmmsg(fd, headers, static_cast<unsigned>(count), MSG_DONTWAIT);
+                if (n <= 0) {
+                    break;
+                }
+                sent += static_cast<std::size_t>(n);
+                if (static_cast<std::size_t>(n) < count) {
+                    break;
+                }
+            }
+            return sent;
+        }
+
+        bool receive(Message& msg) override {
+            uint8_t frame[MAX_FRAME_SIZE];
+            ssize_t size = recv(fd, frame, sizeof(frame), MSG_DONTWAIT);
+            return size > 0 &&
+                   decodeFrame(std::span<const uint8_t>(frame, static_cast<std::size_t>(size)), msg).status == WireStatus::OK;
+        }
+
+        bool waitReadable(int timeoutMs) override {
+            pollfd pfd{ fd, POLLIN, 0 };
+            return poll(&pfd, 1, timeoutMs) > 0;
+        }
+
+        int pollFd() const override { return fd; }
+
+        BusCodec* packetCodec() override { return &codec; }
+
+    private:
+        int fd;
+        BinaryCodec codec;
+    };
+
+    struct Usage {
+        double cpuSeconds = 0;
+        long wakeups = 0;
+    };
+
+    double seconds(const timeval& t) {
+        return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_usec) / 1e6;
+    }
+
+    Usage usage(int who) {
+        rusage ru{};
+        getrusage(who, &ru);
+        return { seconds(ru.ru_utime) + seconds(ru.ru_stime), ru.ru_nvcsw };
+    }
+
+    // Writes rate msg/s round-robin over senders until stopped; reports
+    // its own usage so it can be subtracted
+    struct Generator {
+        std::vector<std::unique_ptr<PairTransport>>& senders;
+        int rate;
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> sent{0};
+        Usage own;
+        std::thread thread;
+
+        Generator(std::vector<std::unique_ptr<PairTransport>>& senders, int rate) : senders(senders), rate(rate) {
+            thread = std::thread([this] { run(); });
+        }
+
+        void run() {
+            Message msg = Message::make(1, 2, ButtonPress{ 3, true });
+            std::size_t next = 0;
+            int perBatch = rate * PACE_MS / 1000;
+            while (running.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < perBatch; ++i) {
+                    msg.seq++;
+                    if (senders[next]->send(msg)) {
+                        sent.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    next = (next + 1) % senders.size();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(PACE_MS));
+            }
+            own = usage(RUSAGE_THREAD);
+        }
+
+        void stop() {
+            running.store(false);
+            thread.join();
+        }
+    };
+
+    struct Result {
+        const char* model;
+        std::size_t endpoints;
+        const char* phase;
+        double cpuSeconds;
+        long wakeups;
+        uint64_t syscalls;      // Loop's own count; 0 for thread/endpoint
+        uint64_t delivered;
+        uint64_t offered;
+        double seconds;
+    };
+
+    void print(const Result& r) {
+        char syscalls[16] = "      -";
+        if (r.syscalls > 0 && r.delivered > 0) {
+            std::snprintf(syscalls, sizeof(syscalls), "%7.1f", 1000.0 * static_cast<double>(r.syscalls) / static_cast<double>(r.delivered));
+        }
+        std::printf("%-16s %4zu endpoints  %-6s  cpu %5.1f%%  wakeups %8.0f/s  syscalls/1k %s  msgs/s %9.0f  delivered %lu/%lu\n",
+                    r.model, r.endpoints, r.phase, 100.0 * std::max(r.cpuSeconds, 0.0) / r.seconds,
+                    static_cast<double>(r.wakeups) / r.seconds, syscalls, static_cast<double>(r.delivered) / r.seconds,
+                    static_cast<unsigned long>(r.delivered), static_cast<unsigned long>(r.offered));
+    }
+
+    // Receivers are already running; measure one phase at rate msg/s
+    Result measure(const char* model, std::size_t endpoints, int rate,
+                   std::vector<std::unique_ptr<PairTransport>>& senders, const std::atomic<uint64_t>& received) {
+        uint64_t receivedBefore = received.load();
+        Usage before = usage(RUSAGE_SELF);
+        Generator generator(senders, rate);
+        std::this_thread::sleep_for(PHASE);
+        generator.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));    // Let the receivers catch up
+        Usage after = usage(RUSAGE_SELF);
+
+        return { model, endpoints, rate == 0 ? "idle" : "loaded",
+                 after.cpuSeconds - before.cpuSeconds - generator.own.cpuSeconds,
+                 after.wakeups - before.wakeups - generator.own.wakeups, 0,
+                 received.load() - receivedBefore, generator.sent.load(), std::chrono::duration<double>(PHASE).count() };
+    }
+
+    void makePairs(std::size_t n, std::vector<std::unique_ptr<PairTransport>>& senders,
+                   std::vector<std::unique_ptr<PairTransport>>& receivers) {
+        for (std::size_t i = 0; i < n; ++i) {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) {
+                std::perror("socketpair");
+                std::exit(1);
+            }
+            senders.push_back(std::make_unique<PairTransport>(fds[0]));
+            receivers.push_back(std::make_unique<PairTransport>(fds[1]));
+        }
+    }
+
+    // The loop runs only for the phase, so its stats are read once it stops
+    Result receivePhase(BusLoop& loop, std::size_t n, int rate,
+                        std::vector<std::unique_ptr<PairTransport>>& senders, const std::atomic<uint64_t>& received) {
+        uint64_t syscallsBefore = loop.stats().syscalls;
+        std::thread thread([&loop] { loop.run(); });
+        Result result = measure(loop.backendName(), n, rate, senders, received);
+        loop.stop();
+        thread.join();
+        result.syscalls = loop.stats().syscalls - syscallsBefore;
+        return result;
+    }
+
+    // The loop sends from its own tick timer, as the controller does
+    Result sendPhase(BusBackend backend, std::size_t n) {
+        std::vector<std::unique_ptr<PairTransport>> senders, receivers;
+        makePairs(n, senders, receivers);
+
+        std::unique_ptr<BusLoop> reader = makeBusLoop(BusBackend::EPOLL);
+        std::atomic<uint64_t> received{0};
+        for (auto& receiver : receivers) {
+            reader->addEndpoint(*receiver, [&received](const Message&) { received.fetch_add(1, std::memory_order_relaxed); });
+        }
+        std::thread readerThread([&reader] { reader->run(); });
+
+        std::unique_ptr<BusLoop> loop = makeBusLoop(backend);
+        Message msg = Message::make(1, 2, ButtonPress{ 3, true });
+        std::size_t next = 0;
+        uint64_t attempted = 0;
+        int timer = loop->addTimer(std::chrono::milliseconds(PACE_MS), [&](uint64_t expirations) {
+            uint64_t count = expirations * static_cast<uint64_t>(SEND_RATE * PACE_MS / 1000);
+            for (uint64_t i = 0; i < count; ++i) {
+                msg.seq++;
+                ++attempted;
+                loop->send(*senders[next], msg);
+                next = (next + 1) % senders.size();
+            }
+            loop->flush();
+        });
+
+        Usage before = usage(RUSAGE_SELF);
+        std::thread stopper([&loop] {
+            std::this_thread::sleep_for(PHASE);
+            loop->stop();
+        });
+        loop->run();
+        stopper.join();
+        loop->removeTimer(timer);
+        // Wait out what is still queued or in flight; failed sends count as
+        // dropped whether send() refused them or the kernel did
+        uint64_t deadline = bench::nowNs() + 1'000'000'000;
+        while (received.load() + loop->stats().dropped < attempted && bench::nowNs() < deadline) {
+            loop->flush();
+            loop->runOnce(1);
+        }
+        Usage after = usage(RUSAGE_SELF);
+
+        reader->stop();
+        readerThread.join();
+        return { loop->backendName(), n, "send", after.cpuSeconds - before.cpuSeconds, after.wakeups - before.wakeups,
+                 loop->stats().syscalls, received.load(), attempted, std::chrono::duration<double>(PHASE).count() };
+    }
+
+    void eventLoop(BusBackend backend, std::size_t n, std::vector<Result>& results) {
+        std::vector<std::unique_ptr<PairTransport>> senders, receivers;
+        makePairs(n, senders, receivers);
+
+        std::unique_ptr<BusLoop> loop = makeBusLoop(backend);
+        std::atomic<uint64_t> received{0};
+        for (auto& receiver : receivers) {
+            loop->addEndpoint(*receiver, [&received](const Message&) { received.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        results.push_back(receivePhase(*loop, n, 0, senders, received));
+        results.push_back(receivePhase(*loop, n, LOADED_RATE, senders, received));
+        loop.reset();
+        results.push_back(sendPhase(backend, n));
+    }
+
+    void threadPerEndpoint(std::size_t n, std::vector<Result>& results) {
+        std::vector<std::unique_ptr<PairTransport>> senders, receivers;
+        makePairs(n, senders, receivers);
+
+        std::atomic<uint64_t> received{0};
+        std::vector<std::unique_ptr<PipeBusClient>> clients;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto client = std::make_unique<PipeBusClient>("bench_" + std::to_string(i));
+            std::shared_ptr<BusTransport> transport(std::move(receivers[i]));
+            client->attach(transport);
+            client->on_receive([&received](const Message&) { received.fetch_add(1, std::memory_order_relaxed); });
+            client->start_receiving();
+            clients.push_back(std::move(client));
+        }
+
+        results.push_back(measure("thread/endpoint", n, 0, senders, received));
+        results.push_back(measure("thread/endpoint", n, LOADED_RATE, senders, received));
+
+        // Each receive thread only notices the stop at its next poll
+        // timeout; stop them together rather than one timeout apiece
+        std::vector<std::thread> stoppers;
+        for (auto& client : clients) {
+            stoppers.emplace_back([&client] { client.reset(); });
+        }
+        for (auto& stopper : stoppers) {
+            stopper.join();
+        }
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+
+    // The bus classes log every setup step, and the clients stopped in
+    // parallel log at once; keep the table, printed with printf, readable
+    bench::NullBuffer discard;
+    std::streambuf* console = std::cout.rdbuf(&discard);
+
+    for (std::size_t n : { 8, 64, 512 }) {
+        std::vector<Result> results;
+        eventLoop(BusBackend::EPOLL, n, results);
+        eventLoop(BusBackend::IO_URING, n, results);
+        threadPerEndpoint(n, results);
+        for (const Result& result : results) {
+            print(result);
+        }
+    }
+    std::cout.rdbuf(console);
+    return 0;
+}
@@ -0,0 +1,145 @@
+// message_view_bench.cpp
+//
+// Receive-side cost of reading a wire frame (bus/message_view.hpp): a full
+// decodeFrame into a Message against a MessageView over the frame in place.
+// The handler does what the bus's own consumers mostly do:
+//
+//   route     read type() and to(), as RoutingTable and the bridge's
+//             route match do
+//   payload   read type() and one payload field, as a pin or phase
+//             handler does
+//
+// Frames are pre-encoded into MAX_FRAME_SIZE slots, with and without
+// WIRE_FLAG_CRC, so only reading them is timed.
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/message_registry.hpp"
+#include "bus/message_view.hpp"
+#include "bus/wire_format.hpp"
+
+namespace {
+
+    constexpr std::size_t MESSAGES = 1 << 12;     // 128 KB of frames, cache-warm like a receive buffer
+    constexpr int PASSES = 1000;
+
+    struct Frames {
+        std::vector<uint8_t> bytes;
+        std::vector<std::size_t> sizes;
+
+        std::span<const uint8_t> operator[](std::size_t i) const {
+            return std::span<const uint8_t>(bytes).subspan(i * MAX_FRAME_SIZE, sizes[i]);
+        }
+    };
+
+    Frames makeFrames(bool withCrc) {
+        std::mt19937 rng(20);
+        Frames frames{ std::vector<uint8_t>(MESSAGES * MAX_FRAME_SIZE), std::vector<std::size_t>(MESSAGES) };
+        for (std::size_t i = 0; i < MESSAGES; ++i) {
+            SymbolId from = static_cast<SymbolId>(1 + rng() % 200);
+            SymbolId to = static_cast<SymbolId>(1 + rng() % 200);
+            SymbolId id = static_cast<SymbolId>(1 + rng() % 200);
+            Message msg;
+            switch (rng() % 3) {
+            case 0:
+                msg = Message::make(from, to, ButtonPress{ id, (i & 1) != 0 });
+                break;
+            case 1:
+                msg = Message::make(from, to, StateTransition{ static_cast<uint8_t>(rng() % 6) });
+                break;
+            default:
+                msg = Message::make(from, to, AnalogSample{ id, static_cast<int32_t>(rng() % 2048) - 1024 });
+                break;
+            }
+            msg.seq = static_cast<uint32_t>(i);
+            frames.sizes[i] = encodeFrame(msg, std::span(frames.bytes).subspan(i * MAX_FRAME_SIZE, MAX_FRAME_SIZE), withCrc);
+        }
+        return frames;
+    }
+
+    // One field per payload type, so the handler cannot be skipped
+    uint64_t field(const Message& msg) {
+        uint64_t value = 0;
+        dispatchMessage(msg, detail::Overloaded{
+            [&value](const ButtonPress& press) { value = press.pressed; },
+            [&value](const StateTransition& transition) { value = transition.phase; },
+            [&value](const AnalogSample& sample) { value = static_cast<uint32_t>(sample.value); } });
+        return value;
+    }
+
+    uint64_t field(const MessageView& view) {
+        switch (view.type()) {
+        case MessageType::BUTTON_PRESS: return view.payload<ButtonPress>().pressed;
+        case MessageType::STATE_TRANSITION: return view.payload<StateTransition>().phase;
+        case MessageType::ANALOG_SAMPLE: return static_cast<uint32_t>(view.payload<AnalogSample>().value);
+        default: return 0;
+        }
+    }
+
+    template <typename F>
+    void time(const char* frames, const char* handler, const char* reader, F&& pass) {
+        uint64_t sum = pass();  // Warm up
+        uint64_t start = bench::nowNs();
+        for (int i = 0; i < PASSES; ++i) {
+            sum += pass();
+            bench::keep(sum);   // Clobbers memory, so a pass cannot be hoisted out of the loop
+        }
+        double ns = static_cast<double>(bench::nowNs() - start) / (static_cast<double>(MESSAGES) * PASSES);
+        bench::keep(sum);
+        std::printf("%-7s %-8s %-12s %6.2f ns/msg\n", frames, handler, reader, ns);
+    }
+
+    void run(const char* name, bool withCrc) {
+        Frames frames = makeFrames(withCrc);
+
+        time(name, "route", "decodeFrame", [&frames] {
+            uint64_t sum = 0;
+            Message msg;
+            for (std::size_t i = 0; i < MESSAGES; ++i) {
+                if (decodeFrame(frames[i], msg).status == WireStatus::OK) {
+                    sum += static_cast<uint64_t>(msg.type) + msg.to;
+                }
+            }
+            return sum;
+        });
+        time(name, "route", "MessageView", [&frames] {
+            uint64_t sum = 0;
+            MessageView view;
+            for (std::size_t i = 0; i < MESSAGES; ++i) {
+                if (MessageView::parse(frames[i], view) == WireStatus::OK) {
+                    sum += static_cast<uint64_t>(view.type()) + view.to();
+                }
+            }
+            return sum;
+        });
+        time(name, "payload", "decodeFrame", [&frames] {
+            uint64_t sum = 0;
+            Message msg;
+            for (std::size_t i = 0; i < MESSAGES; ++i) {
+                if (decodeFrame(frames[i], msg).status == WireStatus::OK) {
+                    sum += field(msg);
+                }
+            }
+            return sum;
+        });
+        time(name, "payload", "MessageView", [&frames] {
+            uint64_t sum = 0;
+            MessageView view;
+            for (std::size_t i = 0; i < MESSAGES; ++i) {
+                if (MessageView::parse(frames[i], view) == WireStatus::OK) {
+                    sum += field(view);
+                }
+            }
+            return sum;
+        });
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+    run("plain", false);
+    run("crc", true);
+    return 0;
+}
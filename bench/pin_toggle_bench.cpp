@@ -0,0 +1,116 @@
+// pin_toggle_bench.cpp
+//
+// Cost of one pin toggle reaching the controller's pin endpoint, the way
+// writeToPipe used to do it against the way it does now (bus/endpoint_cache.hpp):
+//
+//   open/send/close   a fresh UdsClientTransport per toggle, as the old
+//                     writeToPipe opened and closed the pipe each time
+//   endpointCache     endpointCache().send(pipeName, ...), writeToPipe now
+//   held endpoint     send on the transport PinSim acquires once and keeps
+//
+// A UdsServerTransport drained by its own thread stands in for the
+// controller. A toggle whose send finds the socket full yields to the
+// server and retries, so toggles/s is the rate that actually gets through,
+// measured until every toggle has been received. Latency covers each
+// toggle's sends, retries included.
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/endpoint_cache.hpp"
+#include "bus/symbol_table.hpp"
+#include "bus/uds_transport.hpp"
+
+namespace {
+
+    constexpr int TOGGLES = 20'000;
+    constexpr int MAX_RETRIES = 1000;      // Per toggle, then it counts as failed
+    const std::string PIPE = "bench_pin_toggle";
+
+    struct Server {
+        UdsServerTransport transport{ PIPE };
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> received{0};
+        std::thread thread;
+
+        Server() {
+            thread = std::thread([this] {
+                Message msg;
+                while (running.load(std::memory_order_relaxed)) {
+                    if (transport.waitReadable(50)) {
+                        while (transport.receive(msg)) {
+                            received.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            });
+        }
+
+        ~Server() {
+            running.store(false);
+            thread.join();
+        }
+    };
+
+    template <typename Toggle>
+    void run(const char* name, Server& server, Toggle&& toggle) {
+        SymbolId pin = symbols().intern("phc_a:PB1");
+        std::vector<uint64_t> samples;
+        samples.reserve(TOGGLES);
+        uint64_t before = server.received.load();
+        int failed = 0;
+
+        uint64_t start = bench::nowNs();
+        for (int i = 0; i < TOGGLES; ++i) {
+            Message msg = Message::make(pin, NO_SYMBOL, ButtonPress{ pin, (i & 1) != 0 });
+            uint64_t t0 = bench::nowNs();
+            int retries = 0;
+            while (!toggle(msg) && ++retries <= MAX_RETRIES) {
+                std::this_thread::yield();
+            }
+            failed += retries > MAX_RETRIES ? 1 : 0;
+            samples.push_back(bench::nowNs() - t0);
+        }
+        uint64_t expected = static_cast<uint64_t>(TOGGLES - failed);
+        uint64_t deadline = bench::nowNs() + 5'000'000'000ull;
+        while (server.received.load() - before < expected && bench::nowNs() < deadline) {
+            std::this_thread::yield();
+        }
+        double seconds = static_cast<double>(bench::nowNs() - start) / 1e9;
+
+        std::printf("%-16s  %8.0f toggles/s  p50 %7.2f us  p99 %7.2f us  delivered %lu/%d\n", name,
+                    static_cast<double>(TOGGLES) / seconds, static_cast<double>(bench::percentile(samples, 0.5)) / 1000.0,
+                    static_cast<double>(bench::percentile(samples, 0.99)) / 1000.0,
+                    static_cast<unsigned long>(server.received.load() - before), TOGGLES);
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+
+    // Transports log every connect; keep the table readable. The table
+    // itself goes out through printf.
+    bench::NullBuffer discard;
+    std::streambuf* console = std::cout.rdbuf(&discard);
+    std::streambuf* errors = std::cerr.rdbuf(&discard);
+
+    {
+        Server server;
+        run("open/send/close", server, [](const Message& msg) {
+            UdsClientTransport transport(PIPE);
+            return transport.send(msg);
+        });
+        run("endpointCache", server, [](const Message& msg) { return endpointCache().send(PIPE, msg); });
+        std::shared_ptr<BusTransport> endpoint = endpointCache().acquire(PIPE);
+        run("held endpoint", server, [&endpoint](const Message& msg) { return endpoint->send(msg); });
+        endpointCache().clear();
+    }
+    std::cout.rdbuf(console);
+    std::cerr.rdbuf(errors);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// scram_wait_bench.cpp
+//
+// How long a SCRAM press waits in MessageBus during a fuel-rod button storm.
+// An I/O thread pushes 10k ButtonPress msg/s plus a SCRAM press at random
+// intervals; the tick thread swaps every 50 ms (tick_interval_ms) and
+// handles inbound traffic in priority order at ~1 us per message. Run
+// twice: SCRAM in the SAFETY lane as configured, and in the shared CONTROL
+// lane as all traffic was before priority lanes.
+//
+// wait     enqueue (pushInbound) until the tick thread handles it
+// ahead    messages handled before it in the same tick
+// lost     presses rejected because their lane was full
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/message_bus.hpp"
+
+namespace {
+
+    constexpr int STORM_RATE = 10'000;                  // msg/s
+    constexpr auto TICK = std::chrono::milliseconds(50);
+    constexpr auto DURATION = std::chrono::seconds(6);
+    constexpr uint64_t HANDLE_NS = 1'000;               // Work per handled message
+
+    void spin(uint64_t ns) {
+        uint64_t until = bench::nowNs() + ns;
+        while (bench::nowNs() < until) {
+        }
+    }
+
+    void run(const char* name, bool safetyLane) {
+        SymbolId panel = symbols().intern("fuel_rod_panel");
+        SymbolId controller = symbols().intern("main_controller");
+        SymbolId scram = symbols().intern("SCRAM");
+        SymbolId rod = symbols().intern("FUEL_ROD_1");
+
+        MessageBus bus;
+        if (safetyLane) {
+            bus.assignLane(scram, Lane::SAFETY);
+        }
+
+        std::atomic<bool> running{true};
+        std::atomic<uint32_t> scramsLost{0};
+        std::thread io([&] {
+            std::mt19937 rng(7);
+            std::uniform_int_distribution<int> nextScram(20, 60);   // ms apart
+            auto period = std::chrono::nanoseconds(1'000'000'000 / STORM_RATE);
+            auto next = std::chrono::steady_clock::now();
+            auto scramAt = next + std::chrono::milliseconds(nextScram(rng));
+            uint32_t seq = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                // Catch up in bursts after a sleep, as a socket reader would
+                auto now = std::chrono::steady_clock::now();
+                while (next <= now) {
+                    Message press = Message::make(panel, controller, ButtonPress{ rod, (seq & 1) != 0 });
+                    press.seq = ++seq;
+                    bus.pushInbound(press);
+                    next += period;
+                }
+                if (now >= scramAt) {
+                    Message press = Message::make(panel, controller, ButtonPress{ scram, true });
+                    press.seq = ++seq;
+                    if (!bus.pushInbound(press)) {
+                        scramsLost.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    scramAt = now + std::chrono::milliseconds(nextScram(rng));
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+
+        std::vector<uint64_t> waits;
+        std::vector<uint64_t> ahead;
+        uint64_t handled = 0;
+        auto end = std::chrono::steady_clock::now() + DURATION;
+        auto nextTick = std::chrono::steady_clock::now() + TICK;
+        while (nextTick < end) {
+            std::this_thread::sleep_until(nextTick);
+            nextTick += TICK;
+            bus.swapBuffers();
+            uint64_t position = 0;
+            bus.forEachInbound([&](const Message& msg) {
+                spin(HANDLE_NS);
+                ++handled;
+                if (msg.getButtonPress().button_id == scram) {
+                    waits.push_back(bench::nowNs() - msg.enqueueNs);
+                    ahead.push_back(position);
+                }
+                ++position;
+            });
+        }
+        running.store(false);
+        io.join();
+
+        // Whole ticks waited: anything past one tick interval sat through extra swaps
+        uint64_t tickNs = static_cast<uint64_t>(std::chrono::nanoseconds(TICK).count());
+        uint64_t worstTicks = 0;
+        for (uint64_t wait : waits) {
+            worstTicks = std::max(worstTicks, wait / tickNs);
+        }
+        std::size_t received = waits.size();
+        std::printf("%-12s scram %3zu handled, %3u lost  wait p50 %5.2f ms  p99 %5.2f ms  max %5.2f ms  "
+                    "extra ticks %lu  ahead p99 %3lu max %3lu\n",
+                    name, received, scramsLost.load(), bench::percentile(waits, 0.50) / 1e6,
+                    bench::percentile(waits, 0.99) / 1e6, bench::percentile(waits, 1.0) / 1e6,
+                    static_cast<unsigned long>(worstTicks), static_cast<unsigned long>(bench::percentile(ahead, 0.99)),
+                    static_cast<unsigned long>(bench::percentile(ahead, 1.0)));
+        bench::keep(handled);
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+    std::printf("storm %d msg/s, tick %lld ms, %lld s per case\n", STORM_RATE,
+                static_cast<long long>(TICK.count()), static_cast<long long>(DURATION.count()));
+    run("safety lane", true);
+    run("shared fifo", false);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// shm_transport_bench.cpp
+//
+// Cross-process bus links: ShmTransport (bus/shm_transport.hpp) against a
+// SOCK_SEQPACKET socket pair carrying wire frames, the per-message work of
+// UdsClientTransport. The benchmark forks; the child echoes.
+//
+//   round trip  send one message and wait for its echo; latency per trip
+//   stream      send a burst as fast as the link takes it, then wait for
+//               the child to acknowledge the last one
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bench_common.hpp"
+#include "bus/message_types.hpp"
+#include "bus/shm_transport.hpp"
+#include "bus/wire_format.hpp"
+
+namespace {
+
+    constexpr std::size_t ROUND_TRIPS = 20'000;
+    constexpr std::size_t STREAM_MESSAGES = 1'000'000;
+    constexpr uint32_t STREAMED = 0x80000000;      // seq bit of messages not echoed
+    constexpr uint32_t LAST = 0xFFFFFFFF;          // seq of the message ending a stream
+
+    Message sample(uint32_t seq) {
+        Message msg = Message::make(1, 2, ButtonPress{ 3, (seq & 1) != 0 });
+        msg.seq = seq;
+        return msg;
+    }
+
+    // One end of a link, as the benchmark loops need it
+    struct ShmLink {
+        ShmTransport transport;
+
+        ShmLink(const std::string& local, const std::string& peer) : transport(local, peer) {}
+
+        void send(const Message& msg) {
+            while (!transport.send(msg)) {
+                sched_yield();
+            }
+        }
+
+        Message receive() {
+            Message msg;
+            while (!transport.receive(msg)) {
+                transport.waitReadable(1000);
+            }
+            return msg;
+        }
+    };
+
+    struct SocketLink {
+        int fd;
+
+        void send(const Message& msg) {
+            uint8_t frame[MAX_FRAME_SIZE];
+            std::size_t size = encodeFrame(msg, frame);
+            while (::send(fd, frame, size, 0) < 0 && errno == EINTR) {
+            }
+        }
+
+        Message receive() {
+            uint8_t frame[MAX_FRAME_SIZE];
+            Message msg;
+            ssize_t size = recv(fd, frame, sizeof(frame), 0);
+            if (size <= 0 || decodeFrame(std::span<const uint8_t>(frame, static_cast<std::size_t>(size)), msg).status != WireStatus::OK) {
+                std::perror("recv");
+                std::exit(1);
+            }
+            return msg;
+        }
+    };
+
+    // Child: echo every round trip, count a stream and acknowledge its end
+    template <typename Link>
+    void echo(Link& link) {
+        for (;;) {
+            Message msg = link.receive();
+            if (msg.type == MessageType::NONE) {
+                return;
+            }
+            if ((msg.seq & STREAMED) == 0 || msg.seq == LAST) {
+                link.send(msg);
+            }
+        }
+    }
+
+    template <typename Link>
+    void drive(const char* name, Link& link) {
+        std::vector<uint64_t> latencies;
+        latencies.reserve(ROUND_TRIPS);
+        for (uint32_t i = 0; i < ROUND_TRIPS; ++i) {
+            uint64_t start = bench::nowNs();
+            link.send(sample(i));
+            link.receive();
+            latencies.push_back(bench::nowNs() - start);
+        }
+        std::printf("round trip  %-7s p50 %7lu ns  p99 %8lu ns  max %9lu ns\n", name,
+                    static_cast<unsigned long>(bench::percentile(latencies, 0.50)),
+                    static_cast<unsigned long>(bench::percentile(latencies, 0.99)),
+                    static_cast<unsigned long>(bench::percentile(latencies, 1.0)));
+
+        uint64_t start = bench::nowNs();
+        for (uint32_t i = 0; i < STREAM_MESSAGES; ++i) {
+            link.send(sample(i + 1 == STREAM_MESSAGES ? LAST : (i | STREAMED)));
+        }
+        link.receive();
+        double seconds = static_cast<double>(bench::nowNs() - start) / 1e9;
+        std::printf("stream      %-7s %7.2f M msg/s\n", name, STREAM_MESSAGES / seconds / 1e6);
+
+        link.send(Message{});
+    }
+
+    // Run the parent and child halves of one case; make() builds each end
+    template <typename MakeParent, typename MakeChild>
+    void run(const char* name, MakeParent makeParent, MakeChild makeChild) {
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child < 0) {
+            std::perror("fork");
+            std::exit(1);
+        }
+        if (child == 0) {
+            auto link = makeChild();
+            echo(*link);
+            link.reset();
+            std::fflush(stdout);
+            _exit(0);
+        }
+        auto link = makeParent();
+        drive(name, *link);
+        int status = 0;
+        waitpid(child, &status, 0);
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+
+    std::string parentName = "bench_parent_" + std::to_string(getpid());
+    std::string childName = "bench_child_" + std::to_string(getpid());
+    run("shm",
+        [&] { return std::make_unique<ShmLink>(parentName, childName); },
+        [&] { return std::make_unique<ShmLink>(childName, parentName); });
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) {
+        std::perror("socketpair");
+        return 1;
+    }
+    run("socket",
+        [&] { return std::make_unique<SocketLink>(SocketLink{ fds[0] }); },
+        [&] { return std::make_unique<SocketLink>(SocketLink{ fds[1] }); });
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
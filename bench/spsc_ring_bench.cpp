@@ -0,0 +1,145 @@
+// spsc_ring_bench.cpp
+//
+// MessageBus queue backends: the SPSC ring (bus/spsc_ring.hpp) against the
+// growable std::vector queue it replaced.
+//
+//   same thread   push a tick's worth of messages, then drain them
+//   cross thread  an I/O thread pushes, the tick thread pops; the vector
+//                 needs a mutex for this, the ring does not. Latency is
+//                 push to pop, per message.
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/message_types.hpp"
+#include "bus/spsc_ring.hpp"
+
+namespace {
+
+    constexpr std::size_t BATCH = 256;              // One tick's inbound traffic
+    constexpr std::size_t SAME_THREAD_MESSAGES = 20'000'000;
+    constexpr std::size_t CROSS_THREAD_MESSAGES = 2'000'000;
+
+    Message sample(uint32_t seq) {
+        Message msg = Message::make(1, 2, ButtonPress{ 3, (seq & 1) != 0 });
+        msg.seq = seq;
+        return msg;
+    }
+
+    // The pre-ring MessageBus queue: push_back, then read and clear()
+    struct VectorQueue {
+        std::vector<Message> items;
+        std::mutex lock;    // Only taken in the cross-thread case
+    };
+
+    void sameThreadVector() {
+        VectorQueue queue;
+        uint64_t sum = 0;
+        uint64_t start = bench::nowNs();
+        for (std::size_t done = 0; done < SAME_THREAD_MESSAGES; done += BATCH) {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                queue.items.push_back(sample(static_cast<uint32_t>(done + i)));
+            }
+            for (const Message& msg : queue.items) {
+                sum += msg.seq;
+            }
+            queue.items.clear();
+        }
+        double seconds = static_cast<double>(bench::nowNs() - start) / 1e9;
+        bench::keep(sum);
+        std::printf("same thread   vector     %7.1f M msg/s\n", SAME_THREAD_MESSAGES / seconds / 1e6);
+    }
+
+    void sameThreadRing() {
+        SpscRing<Message> ring(BATCH);
+        uint64_t sum = 0;
+        uint64_t start = bench::nowNs();
+        for (std::size_t done = 0; done < SAME_THREAD_MESSAGES; done += BATCH) {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                ring.tryPush(sample(static_cast<uint32_t>(done + i)));
+            }
+            Message msg;
+            while (ring.tryPop(msg)) {
+                sum += msg.seq;
+            }
+        }
+        double seconds = static_cast<double>(bench::nowNs() - start) / 1e9;
+        bench::keep(sum);
+        std::printf("same thread   spsc ring  %7.1f M msg/s\n", SAME_THREAD_MESSAGES / seconds / 1e6);
+    }
+
+    void report(const char* name, uint64_t startNs, std::vector<uint64_t>& latencies) {
+        double seconds = static_cast<double>(bench::nowNs() - startNs) / 1e9;
+        std::printf("cross thread  %-10s %7.1f M msg/s  latency p50 %6lu ns  p99 %8lu ns  max %9lu ns\n", name,
+                    CROSS_THREAD_MESSAGES / seconds / 1e6, static_cast<unsigned long>(bench::percentile(latencies, 0.50)),
+                    static_cast<unsigned long>(bench::percentile(latencies, 0.99)),
+                    static_cast<unsigned long>(bench::percentile(latencies, 1.0)));
+    }
+
+    void crossThreadVector() {
+        VectorQueue queue;
+        std::vector<uint64_t> latencies;
+        latencies.reserve(CROSS_THREAD_MESSAGES);
+        uint64_t start = bench::nowNs();
+        std::thread producer([&queue] {
+            for (std::size_t i = 0; i < CROSS_THREAD_MESSAGES; ++i) {
+                Message msg = sample(static_cast<uint32_t>(i));
+                msg.enqueueNs = bench::nowNs();
+                std::lock_guard<std::mutex> guard(queue.lock);
+                queue.items.push_back(msg);
+            }
+        });
+        std::vector<Message> drained;
+        while (latencies.size() < CROSS_THREAD_MESSAGES) {
+            {
+                std::lock_guard<std::mutex> guard(queue.lock);
+                drained.swap(queue.items);
+            }
+            uint64_t now = bench::nowNs();
+            for (const Message& msg : drained) {
+                latencies.push_back(now - msg.enqueueNs);
+            }
+            drained.clear();
+        }
+        producer.join();
+        report("vector", start, latencies);
+    }
+
+    void crossThreadRing() {
+        SpscRing<Message> ring(4096);
+        std::vector<uint64_t> latencies;
+        latencies.reserve(CROSS_THREAD_MESSAGES);
+        uint64_t start = bench::nowNs();
+        std::thread producer([&ring] {
+            for (std::size_t i = 0; i < CROSS_THREAD_MESSAGES; ++i) {
+                Message msg = sample(static_cast<uint32_t>(i));
+                msg.enqueueNs = bench::nowNs();
+                while (!ring.tryPush(msg)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        Message msg;
+        while (latencies.size() < CROSS_THREAD_MESSAGES) {
+            if (ring.tryPop(msg)) {
+                latencies.push_back(bench::nowNs() - msg.enqueueNs);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        report("spsc ring", start, latencies);
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+    sameThreadVector();
+    sameThreadRing();
+    crossThreadVector();
+    crossThreadRing();
+    return 0;
+}
@@ -0,0 +1,247 @@
+// wire_format_bench.cpp
+//
+// Binary frames (bus/wire_format.hpp) against the text form the bus used to
+// put on the wire: names joined with commas, as PipeBusClient once built
+// "from,to,type", extended with seq and the payload fields so both carry
+// the same message, and split back apart on commas to read it.
+//
+//   binary      encodeFrame / decodeFrame
+//   binary+crc  the same with WIRE_FLAG_CRC
+//   text        string build / comma split, names resolved through the
+//               symbol table
+//
+// Each case encodes every message into one buffer, then decodes it all
+// back; decoded fields are checked so neither side can be optimized away.
+#include <charconv>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench_common.hpp"
+#include "bus/message_registry.hpp"
+#include "bus/symbol_table.hpp"
+#include "bus/wire_format.hpp"
+
+namespace {
+
+    constexpr std::size_t MESSAGES = 1 << 18;
+    constexpr int PASSES = 10;
+
+    std::vector<Message> makeMessages() {
+        std::vector<SymbolId> names;
+        for (const char* name : { "phc_a", "phc_b", "main_controller", "rod_control", "scram", "phc_a:PB1", "phc_b:POT2" }) {
+            names.push_back(symbols().intern(name));
+        }
+        std::mt19937 rng(15);
+        std::vector<Message> messages;
+        messages.reserve(MESSAGES);
+        for (std::size_t i = 0; i < MESSAGES; ++i) {
+            SymbolId from = names[rng() % names.size()];
+            SymbolId to = names[rng() % names.size()];
+            SymbolId id = names[rng() % names.size()];
+            Message msg;
+            switch (rng() % 3) {
+            case 0:
+                msg = Message::make(from, to, ButtonPress{ id, (i & 1) != 0 });
+                break;
+            case 1:
+                msg = Message::make(from, to, StateTransition{ static_cast<uint8_t>(rng() % 6) });
+                break;
+            default:
+                msg = Message::make(from, to, AnalogSample{ id, static_cast<int32_t>(rng() % 2048) - 1024 });
+                break;
+            }
+            msg.seq = static_cast<uint32_t>(i);
+            messages.push_back(msg);
+        }
+        return messages;
+    }
+
+    // Text form -------------------------------------------------------------
+
+    const char* typeName(MessageType type) {
+        switch (type) {
+        case MessageType::BUTTON_PRESS: return "ButtonPress";
+        case MessageType::STATE_TRANSITION: return "StateTransition";
+        case MessageType::ANALOG_SAMPLE: return "AnalogSample";
+        default: return "Unknown";
+        }
+    }
+
+    std::string toText(const Message& msg) {
+        std::string text = symbols().name(msg.from) + "," + symbols().name(msg.to) + "," + typeName(msg.type) + "," +
+                           std::to_string(msg.seq);
+        dispatchMessage(msg, detail::Overloaded{
+            [&text](const ButtonPress& press) {
+                text += "," + symbols().name(press.button_id) + "," + (press.pressed ? "1" : "0");
+            },
+            [&text](const StateTransition& transition) {
+                text += "," + std::to_string(transition.phase);
+            },
+            [&text](const AnalogSample& sample) {
+                text += "," + symbols().name(sample.channel) + "," + std::to_string(sample.value);
+            } });
+        return text;
+    }
+
+    std::vector<std::string> split(const std::string& text) {
+        std::vector<std::string> fields;
+        std::size_t start = 0;
+        while (true) {
+            std::size_t comma = text.find(',', start);
+            fields.push_back(text.substr(start, comma - start));
+            if (comma == std::string::npos) {
+                return fields;
+            }
+            start = comma + 1;
+        }
+    }
+
+    template <typename T>
+    T number(const std::string& field) {
+        T value{};
+        std::from_chars(field.data(), field.data() + field.size(), value);
+        return value;
+    }
+
+    bool fromText(const std::string& text, Message& msg) {
+        std::vector<std::string> fields = split(text);
+        if (fields.size() < 5) {
+            return false;
+        }
+        SymbolId from = symbols().find(fields[0]);
+        SymbolId to = symbols().find(fields[1]);
+        const std::string& type = fields[2];
+        if (type == "ButtonPress" && fields.size() == 6) {
+            msg = Message::make(from, to, ButtonPress{ symbols().find(fields[4]), fields[5] == "1" });
+        } else if (type == "StateTransition" && fields.size() == 5) {
+            msg = Message::make(from, to, StateTransition{ number<uint8_t>(fields[4]) });
+        } else if (type == "AnalogSample" && fields.size() == 6) {
+            msg = Message::make(from, to, AnalogSample{ symbols().find(fields[4]), number<int32_t>(fields[5]) });
+        } else {
+            return false;
+        }
+        msg.seq = number<uint32_t>(fields[3]);
+        return true;
+    }
+
+    // -----------------------------------------------------------------------
+
+    // Both encodings must reproduce what the bench feeds them
+    bool same(const Message& a, const Message& b) {
+        if (a.from != b.from || a.to != b.to || a.seq != b.seq || a.type != b.type) {
+            return false;
+        }
+        bool equal = false;
+        dispatchMessage(a, detail::Overloaded{
+            [&](const ButtonPress& press) {
+                const ButtonPress& other = PayloadTraits<ButtonPress>::get(b);
+                equal = press.button_id == other.button_id && press.pressed == other.pressed;
+            },
+            [&](const StateTransition& transition) {
+                equal = transition.phase == PayloadTraits<StateTransition>::get(b).phase;
+            },
+            [&](const AnalogSample& sample) {
+                const AnalogSample& other = PayloadTraits<AnalogSample>::get(b);
+                equal = sample.channel == other.channel && sample.value == other.value;
+            } });
+        return equal;
+    }
+
+    struct Timing {
+        double encodeNs = 0;
+        double decodeNs = 0;
+        double bytes = 0;
+        std::size_t mismatches = 0;
+    };
+
+    void print(const char* name, const Timing& t) {
+        std::printf("%-11s  encode %6.1f ns/msg  decode %6.1f ns/msg  round trip %6.1f ns/msg  %5.1f bytes/msg%s\n",
+                    name, t.encodeNs, t.decodeNs, t.encodeNs + t.decodeNs, t.bytes,
+                    t.mismatches ? "  MISMATCH" : "");
+    }
+
+    double perMessage(uint64_t ns) {
+        return static_cast<double>(ns) / (static_cast<double>(MESSAGES) * PASSES);
+    }
+
+    Timing binary(const std::vector<Message>& messages, bool withCrc) {
+        std::vector<uint8_t> buffer(messages.size() * MAX_FRAME_SIZE);
+        std::vector<std::size_t> sizes(messages.size());
+        Timing t;
+
+        uint64_t encodeNs = 0;
+        uint64_t decodeNs = 0;
+        std::vector<Message> decoded(messages.size());
+        for (int pass = 0; pass <= PASSES; ++pass) {     // Pass 0 warms up
+            uint64_t start = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                sizes[i] = encodeFrame(messages[i], std::span(buffer).subspan(i * MAX_FRAME_SIZE, MAX_FRAME_SIZE), withCrc);
+            }
+            uint64_t middle = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                decodeFrame(std::span<const uint8_t>(buffer).subspan(i * MAX_FRAME_SIZE, sizes[i]), decoded[i]);
+            }
+            uint64_t end = bench::nowNs();
+            if (pass > 0) {
+                encodeNs += middle - start;
+                decodeNs += end - middle;
+            }
+        }
+
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            bytes += sizes[i];
+            t.mismatches += same(messages[i], decoded[i]) ? 0 : 1;
+        }
+        t.encodeNs = perMessage(encodeNs);
+        t.decodeNs = perMessage(decodeNs);
+        t.bytes = static_cast<double>(bytes) / static_cast<double>(messages.size());
+        return t;
+    }
+
+    Timing text(const std::vector<Message>& messages) {
+        std::vector<std::string> encoded(messages.size());
+        Timing t;
+
+        uint64_t encodeNs = 0;
+        uint64_t decodeNs = 0;
+        std::vector<Message> decoded(messages.size());
+        for (int pass = 0; pass <= PASSES; ++pass) {
+            uint64_t start = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                encoded[i] = toText(messages[i]);
+            }
+            uint64_t middle = bench::nowNs();
+            for (std::size_t i = 0; i < messages.size(); ++i) {
+                fromText(encoded[i], decoded[i]);
+            }
+            uint64_t end = bench::nowNs();
+            if (pass > 0) {
+                encodeNs += middle - start;
+                decodeNs += end - middle;
+            }
+        }
+
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            bytes += encoded[i].size();
+            t.mismatches += same(messages[i], decoded[i]) ? 0 : 1;
+        }
+        t.encodeNs = perMessage(encodeNs);
+        t.decodeNs = perMessage(decodeNs);
+        t.bytes = static_cast<double>(bytes) / static_cast<double>(messages.size());
+        return t;
+    }
+
+} // namespace
+
+int main() {
+    bench::printHost();
+    std::vector<Message> messages = makeMessages();
+    print("binary", binary(messages, false));
+    print("binary+crc", binary(messages, true));
+    print("text", text(messages));
+    return 0;
+}
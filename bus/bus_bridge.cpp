@@ -0,0 +1,449 @@
+// bus_bridge.cpp
+#ifdef __linux__
+#include "bus_bridge.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "message_registry.hpp"
+#include "wire_format.hpp"
+
+namespace {
+
+    constexpr uint8_t HELLO_MAGIC[3] = { 'F', 'R', 'B' };
+
+    // Resolve "host:port"; the host part may be empty for a wildcard listen
+    addrinfo* resolve(const std::string& address, bool passive) {
+        std::size_t colon = address.rfind(':');
+        if (colon == std::string::npos) {
+            throw std::runtime_error("BusBridge: address must be host:port, got " + address);
+        }
+        std::string host = address.substr(0, colon);
+        std::string port = address.substr(colon + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive ? AI_PASSIVE : 0;
+        addrinfo* result = nullptr;
+        int rc = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (rc != 0) {
+            throw std::runtime_error("BusBridge: cannot resolve " + address + ": " + gai_strerror(rc));
+        }
+        return result;
+    }
+
+    void setNoDelay(int fd) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+} // namespace
+
+BusBridge::BusBridge(BusLoop& loop, std::shared_ptr<BusTransport> local, Config config)
+    : loop(loop), local(std::move(local)), config(std::move(config)) {
+    if (this->config.listen.empty() == this->config.connect.empty()) {
+        throw std::runtime_error("BusBridge " + this->config.name + ": set exactly one of listen or connect");
+    }
+    this->config.batching.maxMessages = std::max<std::size_t>(this->config.batching.maxMessages, 1);
+
+    if (!this->config.listen.empty()) {
+        addrinfo* addresses = resolve(this->config.listen, true);
+        int err = 0;
+        for (addrinfo* ai = addresses; ai && listenFd < 0; ai = ai->ai_next) {
+            int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+            if (fd < 0) {
+                err = errno;
+                continue;
+            }
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, 1) != 0) {
+                err = errno;
+                close(fd);
+                continue;
+            }
+            listenFd = fd;
+        }
+        freeaddrinfo(addresses);
+        if (listenFd < 0) {
+            throw std::runtime_error("BusBridge " + this->config.name + ": cannot listen on " +
+                                     this->config.listen + ": " + std::strerror(err));
+        }
+        loop.addFd(listenFd, [this] { acceptPeer(); });
+        std::cout << "[BusBridge] " << this->config.name << " listening on " << this->config.listen << std::endl;
+    }
+
+    if (this->local) {
+        remoteHandler = [this](const Message& msg) { this->loop.send(*this->local, msg); };
+        loop.addViewEndpoint(*this->local, [this](const MessageView& view) {
+            if (!matches(view.from(), view.to())) {
+                return;
+            }
+            Message msg;
+            if (view.materialize(msg)) {
+                enqueue(msg);
+            }
+        });
+    }
+
+    auto period = this->config.batching.window.count() > 0
+        ? this->config.batching.window
+        : std::chrono::duration_cast<std::chrono::microseconds>(IDLE_TICK);
+    timerId = loop.addTimer(period, [this](uint64_t) { housekeeping(); });
+
+    if (!this->config.connect.empty()) {
+        startConnect();
+    }
+}
+
+BusBridge::~BusBridge() {
+    loop.removeTimer(timerId);
+    if (local) {
+        loop.removeEndpoint(*local);
+    }
+    if (peerFd >= 0) {
+        if (state == PeerState::CONNECTED) {
+            flush();
+            loop.removeFd(peerFd);
+        }
+        close(peerFd);
+    }
+    if (listenFd >= 0) {
+        loop.removeFd(listenFd);
+        close(listenFd);
+    }
+}
+
+void BusBridge::onRemote(BusLoop::MessageHandler handler) {
+    remoteHandler = std::move(handler);
+}
+
+bool BusBridge::matches(SymbolId from, SymbolId to) const {
+    for (const BridgeRoute& route : config.routes) {
+        if ((route.from == NO_SYMBOL || route.from == from) && (route.to == NO_SYMBOL || route.to == to)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BusBridge::forward(const Message& msg) {
+    return matches(msg.from, msg.to) && enqueue(msg);
+}
+
+bool BusBridge::enqueue(const Message& msg) {
+    if (state != PeerState::CONNECTED || tx.size() - txSent > MAX_PENDING_BYTES) {
+        ++bridgeStats.dropped;
+        return false;
+    }
+
+    Message copy = msg;
+    forEachSymbol(copy, [this](SymbolId& id) { announce(id); });
+
+    std::size_t offset = tx.size();
+    tx.resize(offset + 1 + MAX_FRAME_SIZE);
+    tx[offset] = RECORD_MESSAGE;
+    std::size_t size = encodeFrame(msg, std::span<uint8_t>(tx.data() + offset + 1, MAX_FRAME_SIZE));
+    tx.resize(offset + 1 + size);
+    ++bridgeStats.forwarded;
+
+    if (++pendingMessages >= config.batching.maxMessages || config.batching.window.count() <= 0 ||
+        tx.size() - txSent >= FLUSH_BYTES) {
+        flush();
+    }
+    return true;
+}
+
+void BusBridge::announce(SymbolId id) {
+    if (id == NO_SYMBOL || (id < announced.size() && announced[id])) {
+        return;
+    }
+    if (id >= announced.size()) {
+        announced.resize(static_cast<std::size_t>(id) + 1, false);
+    }
+    announced[id] = true;
+
+    const std::string& symbol = symbols().name(id);
+    std::size_t length = std::min(symbol.size(), MAX_SYMBOL_NAME);
+    uint8_t header[1 + 2 * 5];
+    uint8_t* p = header;
+    *p++ = RECORD_SYMBOL;
+    p = detail::putVarint(p, id);
+    p = detail::putVarint(p, static_cast<uint32_t>(length));
+    tx.insert(tx.end(), header, p);
+    tx.insert(tx.end(), symbol.begin(), symbol.begin() + static_cast<std::ptrdiff_t>(length));
+    ++bridgeStats.symbolsSent;
+}
+
+void BusBridge::flush() {
+    pendingMessages = 0;
+    if (state != PeerState::CONNECTED || txSent == tx.size()) {
+        return;
+    }
+
+    ssize_t n = ::send(peerFd, tx.data() + txSent, tx.size() - txSent, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            dropPeer(std::strerror(errno));
+        }
+        return;
+    }
+    ++bridgeStats.flushes;
+    bridgeStats.bytesSent += static_cast<uint64_t>(n);
+    txSent += static_cast<std::size_t>(n);
+    if (txSent == tx.size()) {
+        tx.clear();
+        txSent = 0;
+    } else if (txSent >= FLUSH_BYTES) {
+        // The kernel buffer is full; compact so the backlog does not creep
+        tx.erase(tx.begin(), tx.begin() + static_cast<std::ptrdiff_t>(txSent));
+        txSent = 0;
+    }
+}
+
+void BusBridge::housekeeping() {
+    if (state == PeerState::CONNECTING) {
+        checkConnect();
+    } else if (state == PeerState::DISCONNECTED && !config.connect.empty() &&
+               std::chrono::steady_clock::now() - lastAttempt >= RECONNECT_INTERVAL) {
+        startConnect();
+    }
+    flush();
+}
+
+void BusBridge::startConnect() {
+    lastAttempt = std::chrono::steady_clock::now();
+    addrinfo* addresses;
+    try {
+        addresses = resolve(config.connect, false);
+    } catch (const std::exception& e) {
+        std::cerr << "[BusBridge] " << config.name << ": " << e.what() << std::endl;
+        return;
+    }
+
+    for (addrinfo* ai = addresses; ai; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            freeaddrinfo(addresses);
+            peerUp(fd);
+            return;
+        }
+        if (errno == EINPROGRESS) {
+            // Completion is checked from the timer
+            peerFd = fd;
+            state = PeerState::CONNECTING;
+            freeaddrinfo(addresses);
+            return;
+        }
+        close(fd);
+    }
+    freeaddrinfo(addresses);
+}
+
+void BusBridge::checkConnect() {
+    pollfd pfd{ peerFd, POLLOUT, 0 };
+    if (poll(&pfd, 1, 0) <= 0) {
+        if (std::chrono::steady_clock::now() - lastAttempt >= RECONNECT_INTERVAL) {
+            close(peerFd);
+            peerFd = -1;
+            state = PeerState::DISCONNECTED;
+        }
+        return;
+    }
+
+    int err = 0;
+    socklen_t length = sizeof(err);
+    getsockopt(peerFd, SOL_SOCKET, SO_ERROR, &err, &length);
+    int fd = peerFd;
+    peerFd = -1;
+    state = PeerState::DISCONNECTED;
+    if (err != 0) {
+        close(fd);
+        return;
+    }
+    peerUp(fd);
+}
+
+void BusBridge::acceptPeer() {
+    int fd;
+    while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        if (state == PeerState::CONNECTED) {
+            std::cerr << "[BusBridge] " << config.name << " already has a peer, refusing another" << std::endl;
+            close(fd);
+            continue;
+        }
+        peerUp(fd);
+    }
+}
+
+void BusBridge::peerUp(int fd) {
+    setNoDelay(fd);
+    peerFd = fd;
+    state = PeerState::CONNECTED;
+    ++bridgeStats.connects;
+
+    tx.clear();
+    txSent = 0;
+    pendingMessages = 0;
+    announced.assign(announced.size(), false);
+    rx.clear();
+    helloReceived = false;
+    remoteToLocal.clear();
+
+    tx.push_back(RECORD_HELLO);
+    tx.insert(tx.end(), std::begin(HELLO_MAGIC), std::end(HELLO_MAGIC));
+    tx.push_back(PROTOCOL_VERSION);
+    loop.addFd(peerFd, [this] { readPeer(); });
+    std::cout << "[BusBridge] " << config.name << " connected to peer" << std::endl;
+    flush();
+}
+
+void BusBridge::dropPeer(const char* reason) {
+    if (state == PeerState::CONNECTED) {
+        loop.removeFd(peerFd);
+    }
+    close(peerFd);
+    peerFd = -1;
+    state = PeerState::DISCONNECTED;
+    lastAttempt = std::chrono::steady_clock::now();
+    tx.clear();
+    txSent = 0;
+    std::cerr << "[BusBridge] " << config.name << " lost peer: " << reason << std::endl;
+}
+
+void BusBridge::readPeer() {
+    // Bounded so one busy peer cannot starve the rest of the loop
+    for (int reads = 0; reads < 16; ++reads) {
+        std::size_t offset = rx.size();
+        rx.resize(offset + READ_CHUNK);
+        ssize_t n = recv(peerFd, rx.data() + offset, READ_CHUNK, MSG_DONTWAIT);
+        rx.resize(offset + static_cast<std::size_t>(std::max<ssize_t>(n, 0)));
+        if (n == 0) {
+            dropPeer("closed by peer");
+            return;
+        }
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                dropPeer(std::strerror(errno));
+            }
+            break;
+        }
+        if (!parseRecords()) {
+            dropPeer("protocol error");
+            return;
+        }
+        // A handler may have forwarded a reply that failed and dropped us
+        if (state != PeerState::CONNECTED) {
+            return;
+        }
+        if (static_cast<std::size_t>(n) < READ_CHUNK) {
+            break;
+        }
+    }
+    // Replies to what just arrived go out without waiting for the timer
+    flush();
+}
+
+bool BusBridge::parseRecords() {
+    const uint8_t* p = rx.data();
+    const uint8_t* end = rx.data() + rx.size();
+    while (p < end) {
+        const uint8_t* record = p + 1;
+        uint8_t kind = *p;
+        if (!helloReceived && kind != RECORD_HELLO) {
+            return false;
+        }
+
+        if (kind == RECORD_MESSAGE) {
+            std::span<const uint8_t> rest(record, static_cast<std::size_t>(end - record));
+            std::size_t frameSize = peekFrameSize(rest);
+            if (frameSize > MAX_FRAME_SIZE) {
+                return false;
+            }
+            if (frameSize == 0 || rest.size() < frameSize) {
+                break;
+            }
+            Message msg;
+            if (decodeFrame(rest.first(frameSize), msg).status == WireStatus::OK) {
+                deliverRemote(msg);
+            } else {
+                ++bridgeStats.dropped;
+            }
+            p = record + frameSize;
+        } else if (kind == RECORD_SYMBOL) {
+            const uint8_t* q = record;
+            uint32_t id;
+            uint32_t length;
+            if (!detail::getVarint(q, end, id) || !detail::getVarint(q, end, length)) {
+                // A varint is at most five bytes; anything longer is garbage
+                if (end - record >= 10) {
+                    return false;
+                }
+                break;
+            }
+            if (length > MAX_SYMBOL_NAME || id >= SymbolTable::MAX_SYMBOLS) {
+                return false;
+            }
+            if (static_cast<std::size_t>(end - q) < length) {
+                break;
+            }
+            if (id >= remoteToLocal.size()) {
+                remoteToLocal.resize(static_cast<std::size_t>(id) + 1, NO_SYMBOL);
+            }
+            // Only names this process already knows are mapped; interning
+            // whatever the peer announces would let it fill the table, and
+            // messages naming an unknown symbol are dropped on delivery
+            remoteToLocal[id] = symbols().find(std::string_view(reinterpret_cast<const char*>(q), length));
+            p = q + length;
+        } else if (kind == RECORD_HELLO) {
+            if (end - record < 4) {
+                break;
+            }
+            if (std::memcmp(record, HELLO_MAGIC, sizeof(HELLO_MAGIC)) != 0 || record[3] != PROTOCOL_VERSION) {
+                return false;
+            }
+            helloReceived = true;
+            p = record + 4;
+        } else {
+            return false;
+        }
+    }
+    rx.erase(rx.begin(), rx.begin() + (p - rx.data()));
+    return true;
+}
+
+void BusBridge::deliverRemote(Message& msg) {
+    bool known = true;
+    forEachSymbol(msg, [this, &known](SymbolId& id) {
+        if (id == NO_SYMBOL) {
+            return;
+        }
+        if (id >= remoteToLocal.size() || remoteToLocal[id] == NO_SYMBOL) {
+            known = false;
+            return;
+        }
+        id = remoteToLocal[id];
+    });
+    if (!known) {
+        ++bridgeStats.dropped;
+        return;
+    }
+    ++bridgeStats.received;
+    if (remoteHandler) {
+        remoteHandler(msg);
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,141 @@
+// bus_bridge.hpp
+#pragma once
+#ifdef __linux__
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bus_loop.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+#include "message_view.hpp"
+#include "symbol_table.hpp"
+
+// Local traffic matching a route is forwarded; NO_SYMBOL matches anything
+struct BridgeRoute {
+    SymbolId from = NO_SYMBOL;
+    SymbolId to = NO_SYMBOL;
+};
+
+// Federates a local bus with one on another host. Messages arriving on the
+// local transport that match a route are framed onto a TCP connection to the
+// peer bridge, and messages from the peer are handed to onRemote() (by
+// default, sent on the local transport).
+//
+// The stream is a sequence of records, each a kind byte followed by:
+//   HELLO    "FRB" + version, first record in each direction
+//   SYMBOL   varint id, varint length, name bytes
+//   MESSAGE  one wire frame (wire_format.hpp), self-delimited by its length
+// Symbol ids are process-local, so each side announces a name the first
+// time it sends its id and the receiver maps it through its own table.
+// Names the receiver has never interned are not added; messages using them
+// are dropped. Both tables reset on reconnect.
+//
+// Outbound records are coalesced and written with one send() per flush
+// window, on a TCP_NODELAY socket so a flush is never held back by Nagle.
+// Everything runs on the loop thread. Routes should not send a message back
+// the way it came, or two bridges will echo it between them.
+class BusBridge {
+public:
+    static constexpr std::size_t MAX_PENDING_BYTES = 1 << 20;   // Outbound backlog before dropping
+    static constexpr std::size_t FLUSH_BYTES = 16 * 1024;       // Flush early once this much is queued
+    static constexpr std::chrono::milliseconds RECONNECT_INTERVAL{500};
+    static constexpr std::chrono::milliseconds IDLE_TICK{100};  // Housekeeping when batching is off
+
+    struct Config {
+        std::string name;
+        std::string listen;                 // "host:port" to accept the peer on, or
+        std::string connect;                // "host:port" to dial
+        std::vector<BridgeRoute> routes;    // Empty forwards nothing
+        BusLoop::BatchPolicy batching{ 64, std::chrono::microseconds{500} };
+    };
+
+    struct Stats {
+        uint64_t forwarded = 0;     // Local messages queued for the peer
+        uint64_t received = 0;      // Peer messages handed to onRemote
+        uint64_t dropped = 0;       // Peer down, backlog full, or unknown remote symbol
+        uint64_t flushes = 0;       // send() calls that wrote data
+        uint64_t bytesSent = 0;
+        uint64_t symbolsSent = 0;
+        uint64_t connects = 0;
+    };
+
+    // local may be null for a bridge that only receives; it must not also be
+    // registered with loop elsewhere. Throws std::runtime_error if the listen
+    // address cannot be bound.
+    BusBridge(BusLoop& loop, std::shared_ptr<BusTransport> local, Config config);
+    ~BusBridge();
+
+    BusBridge(const BusBridge&) = delete;
+    BusBridge& operator=(const BusBridge&) = delete;
+
+    // Replace the default delivery of peer messages (ids already mapped)
+    void onRemote(BusLoop::MessageHandler handler);
+
+    // Queue msg for the peer if it matches a route. Returns false if it did
+    // not match or was dropped.
+    bool forward(const Message& msg);
+
+    // Write out everything queued so far
+    void flush();
+
+    bool connected() const { return state == PeerState::CONNECTED; }
+    const std::string& name() const { return config.name; }
+    const Stats& stats() const { return bridgeStats; }
+
+private:
+    enum class PeerState : uint8_t { DISCONNECTED, CONNECTING, CONNECTED };
+
+    enum RecordKind : uint8_t {
+        RECORD_MESSAGE = 0,
+        RECORD_SYMBOL = 1,
+        RECORD_HELLO = 2
+    };
+
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+    static constexpr std::size_t READ_CHUNK = 64 * 1024;
+    static constexpr std::size_t MAX_SYMBOL_NAME = 255;
+
+    bool matches(SymbolId from, SymbolId to) const;
+    bool enqueue(const Message& msg);
+    void announce(SymbolId id);
+
+    void housekeeping();
+    void startConnect();
+    void checkConnect();
+    void acceptPeer();
+    void peerUp(int fd);
+    void dropPeer(const char* reason);
+
+    void readPeer();
+    // Returns false on a protocol error
+    bool parseRecords();
+    void deliverRemote(Message& msg);
+
+    BusLoop& loop;
+    std::shared_ptr<BusTransport> local;
+    Config config;
+    BusLoop::MessageHandler remoteHandler;
+    Stats bridgeStats;
+
+    int listenFd = -1;
+    int peerFd = -1;
+    int timerId = -1;
+    PeerState state = PeerState::DISCONNECTED;
+    std::chrono::steady_clock::time_point lastAttempt{};
+
+    // Outbound: records not yet accepted by the kernel start at txSent
+    std::vector<uint8_t> tx;
+    std::size_t txSent = 0;
+    std::size_t pendingMessages = 0;
+    std::vector<bool> announced;            // Indexed by local SymbolId
+
+    // Inbound: unparsed bytes; a partial record stays at the front
+    std::vector<uint8_t> rx;
+    bool helloReceived = false;
+    std::vector<SymbolId> remoteToLocal;    // Indexed by peer SymbolId
+};
+
+#endif // __linux__
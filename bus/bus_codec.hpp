@@ -0,0 +1,70 @@
+// bus_codec.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <span>
+#include "message_types.hpp"
+#include "wire_format.hpp"
+
+// Encoding used on a message-oriented link
+enum class WireFormat : uint8_t {
+    BINARY,     // wire_format.hpp frames
+    PROTOBUF    // proto/reactor.proto messages, see ProtobufCodec
+};
+
+// Packet codec for transports that carry one Message per packet. encode()
+// and decode() may run on different threads, but each must be serialized by
+// the caller.
+class BusCodec {
+public:
+    static constexpr std::size_t MAX_PACKET_SIZE = 128;
+
+    virtual ~BusCodec() = default;
+
+    // Encode msg into out. Returns the packet size, or 0 if it does not fit.
+    virtual std::size_t encode(const Message& msg, std::span<uint8_t> out) = 0;
+
+    // Decode one whole packet. Returns false if it is malformed.
+    virtual bool decode(std::span<const uint8_t> packet, Message& msg) = 0;
+
+    // End of a receive burst; codecs may recycle per-batch memory here
+    virtual void endBatch() {}
+
+    virtual WireFormat format() const = 0;
+};
+
+class BinaryCodec : public BusCodec {
+public:
+    std::size_t encode(const Message& msg, std::span<uint8_t> out) override {
+        return encodeFrame(msg, out);
+    }
+
+    bool decode(std::span<const uint8_t> packet, Message& msg) override {
+        WireDecodeResult result = decodeFrame(packet, msg);
+        return result.status == WireStatus::OK && result.consumed == packet.size();
+    }
+
+    WireFormat format() const override { return WireFormat::BINARY; }
+};
+
+#ifdef FIDGET_WITH_PROTOBUF
+// Defined in protobuf_codec.cpp, which needs libprotobuf and generated/reactor.pb.cc
+std::unique_ptr<BusCodec> makeProtobufCodec();
+#endif
+
+inline std::unique_ptr<BusCodec> makeBusCodec(WireFormat format) {
+    if (format == WireFormat::PROTOBUF) {
+#ifdef FIDGET_WITH_PROTOBUF
+        return makeProtobufCodec();
+#else
+        std::cerr << "[BusCodec] Built without FIDGET_WITH_PROTOBUF, using binary frames" << std::endl;
+#endif
+    }
+    return std::make_unique<BinaryCodec>();
+}
+
+inline const char* wireFormatName(WireFormat format) {
+    return format == WireFormat::PROTOBUF ? "protobuf" : "binary";
+}
@@ -0,0 +1,295 @@
+// bus_event_loop.cpp
+#ifdef __linux__
+#include "bus_event_loop.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+BusEventLoop::BusEventLoop() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw std::runtime_error("BusEventLoop: epoll_create1 failed: " + std::string(std::strerror(errno)));
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    watch(wakeFd, [this] {
+        uint64_t value;
+        while (read(wakeFd, &value, sizeof(value)) > 0) {}
+    });
+}
+
+BusEventLoop::~BusEventLoop() {
+    close(wakeFd);
+    close(epollFd);
+}
+
+uint64_t BusEventLoop::watch(int fd, std::function<void()> onReady) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        std::cerr << "[BusEventLoop] Failed to watch fd " << fd << ": " << std::strerror(errno) << std::endl;
+        return 0;
+    }
+    uint64_t id = nextWatchId++;
+    handlers[fd] = Watch{ std::move(onReady), id };
+    return id;
+}
+
+void BusEventLoop::forget(int fd, uint64_t id) {
+    auto it = handlers.find(fd);
+    if (it == handlers.end() || it->second.id != id) {
+        // Already gone, or the number now belongs to another watch
+        return;
+    }
+    if (dispatching) {
+        // The handler may be the one running; erase it after the batch
+        deferredRemovals.emplace_back(fd, id);
+    } else {
+        handlers.erase(it);
+    }
+}
+
+bool BusEventLoop::removed(int fd, uint64_t id) const {
+    return std::find(deferredRemovals.begin(), deferredRemovals.end(), std::make_pair(fd, id)) != deferredRemovals.end();
+}
+
+void BusEventLoop::addFd(int fd, std::function<void()> onReady) {
+    watch(fd, std::move(onReady));
+}
+
+void BusEventLoop::removeFd(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    auto it = handlers.find(fd);
+    if (it != handlers.end()) {
+        forget(fd, it->second.id);
+    }
+}
+
+bool BusEventLoop::addViewEndpoint(BusTransport& transport, ViewHandler onMessage) {
+    if (transport.pollFd() < 0) {
+        // Lazily connecting transports only connect when used; try now
+        // rather than at the first refresh
+        transport.waitReadable(0);
+    }
+    int fd = transport.pollFd();
+    auto endpoint = std::make_unique<Endpoint>(Endpoint{ &transport, std::move(onMessage), fd, transport.connectionGeneration() });
+    Endpoint* raw = endpoint.get();
+    endpoints.push_back(std::move(endpoint));
+
+    if (fd < 0) {
+        // Not connected yet or not pollable; refreshEndpoints() retries
+        return false;
+    }
+    raw->watchId = watch(fd, [this, raw] { drain(*raw); });
+    return true;
+}
+
+void BusEventLoop::removeEndpoint(BusTransport& transport) {
+    auto it = std::find_if(endpoints.begin(), endpoints.end(),
+        [&transport](const std::unique_ptr<Endpoint>& e) { return e->transport == &transport; });
+    if (it == endpoints.end()) {
+        return;
+    }
+    for (auto batch = outBatches.begin(); batch != outBatches.end(); ++batch) {
+        if ((*batch)->transport == &transport) {
+            flushBatch(**batch);
+            outBatches.erase(batch);
+            break;
+        }
+    }
+    auto handler = (*it)->fd >= 0 ? handlers.find((*it)->fd) : handlers.end();
+    if (handler != handlers.end() && handler->second.id == (*it)->watchId) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, (*it)->fd, nullptr);
+        forget((*it)->fd, (*it)->watchId);
+    }
+    if (dispatching) {
+        // Keep the Endpoint alive until the batch finishes
+        (*it)->transport = nullptr;
+    } else {
+        endpoints.erase(it);
+    }
+}
+
+void BusEventLoop::drain(Endpoint& endpoint) {
+    if (!endpoint.transport) {
+        return;
+    }
+    MessageView view;
+    std::size_t count = 0;
+    while (count < MAX_BATCH && endpoint.transport->receiveView(view)) {
+        endpoint.onMessage(view);
+        ++count;
+    }
+    loopStats.messages += count;
+    loopStats.syscalls += count + (count < MAX_BATCH ? 1 : 0);
+}
+
+void BusEventLoop::refreshEndpoints() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastRefresh < REFRESH_INTERVAL) {
+        return;
+    }
+    lastRefresh = now;
+
+    for (auto& endpoint : endpoints) {
+        if (!endpoint->transport) {
+            continue;
+        }
+        if (endpoint->transport->pollFd() < 0) {
+            // A zero-timeout wait lets lazily connecting transports retry
+            endpoint->transport->waitReadable(0);
+        }
+        int fd = endpoint->transport->pollFd();
+        uint32_t generation = endpoint->transport->connectionGeneration();
+        if (fd == endpoint->fd && generation == endpoint->generation) {
+            continue;
+        }
+        // Transport reconnected. The old descriptor was closed, which
+        // already dropped it from the epoll set, and its number may now be
+        // another watch's: only our own handler goes, never the number's
+        // epoll registration.
+        if (endpoint->fd >= 0) {
+            forget(endpoint->fd, endpoint->watchId);
+        }
+        endpoint->fd = fd;
+        endpoint->generation = generation;
+        endpoint->watchId = 0;
+        if (fd >= 0) {
+            Endpoint* raw = endpoint.get();
+            endpoint->watchId = watch(fd, [this, raw] { drain(*raw); });
+        }
+    }
+}
+
+bool BusEventLoop::send(BusTransport& transport, const Message& msg) {
+    if (!transport.packetCodec() || transport.pollFd() < 0) {
+        return BusLoop::send(transport, msg);
+    }
+
+    auto it = std::find_if(outBatches.begin(), outBatches.end(),
+        [&transport](const std::unique_ptr<OutBatch>& b) { return b->transport == &transport; });
+    if (it == outBatches.end()) {
+        outBatches.push_back(std::make_unique<OutBatch>());
+        outBatches.back()->transport = &transport;
+        it = outBatches.end() - 1;
+    }
+    OutBatch& batch = **it;
+
+    if (batch.count == 0) {
+        if (batch.messages.size() < policy.maxMessages) {
+            batch.messages.resize(std::max<std::size_t>(policy.maxMessages, 1));
+        }
+        batch.deadline = std::chrono::steady_clock::now() + policy.window;
+    }
+    batch.messages[batch.count++] = msg;
+
+    // Sized when the batch started; the policy may have grown since
+    if (batch.count >= policy.maxMessages || batch.count == batch.messages.size()) {
+        flushBatch(batch);
+    }
+    return true;
+}
+
+void BusEventLoop::flushBatch(OutBatch& batch) {
+    if (batch.count == 0) {
+        return;
+    }
+    std::size_t count = batch.count;
+    batch.count = 0;
+
+    // The transport encodes under its own connection lock and disconnects
+    // if the peer has gone, so a dead link reconnects instead of eating sends
+    std::size_t sent = batch.transport->sendBatch({ batch.messages.data(), count });
+    ++loopStats.syscalls;
+    loopStats.dropped += count - sent;
+    countFlush(sent);
+}
+
+void BusEventLoop::flush() {
+    for (auto& batch : outBatches) {
+        flushBatch(*batch);
+    }
+}
+
+void BusEventLoop::flushExpired() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& batch : outBatches) {
+        if (batch->count > 0 && batch->deadline <= now) {
+            flushBatch(*batch);
+        }
+    }
+}
+
+int BusEventLoop::clampToDeadlines(int timeoutMs) const {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& batch : outBatches) {
+        if (batch->count == 0) {
+            continue;
+        }
+        // Round up so the wait never ends just short of the deadline
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(batch->deadline - now).count();
+        int limit = static_cast<int>(std::max<decltype(remaining)>(remaining, 0));
+        if (timeoutMs < 0 || limit < timeoutMs) {
+            timeoutMs = limit;
+        }
+    }
+    return timeoutMs;
+}
+
+int BusEventLoop::runOnce(int timeoutMs) {
+    epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(epollFd, events, MAX_EVENTS, clampToDeadlines(timeoutMs));
+    ++loopStats.syscalls;
+    if (ready < 0) {
+        if (errno != EINTR) {
+            std::cerr << "[BusEventLoop] epoll_wait failed: " << std::strerror(errno) << std::endl;
+        }
+        flushExpired();
+        return 0;
+    }
+
+    if (ready > 0) {
+        ++loopStats.wakeups;
+        loopStats.events += static_cast<uint64_t>(ready);
+    }
+
+    dispatching = true;
+    for (int i = 0; i < ready; ++i) {
+        int fd = events[i].data.fd;
+        auto it = handlers.find(fd);
+        if (it != handlers.end() && !removed(fd, it->second.id)) {
+            it->second.onReady();
+        }
+    }
+    dispatching = false;
+
+    for (const auto& [fd, id] : deferredRemovals) {
+        auto it = handlers.find(fd);
+        if (it != handlers.end() && it->second.id == id) {
+            handlers.erase(it);
+        }
+    }
+    deferredRemovals.clear();
+    endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(),
+        [](const std::unique_ptr<Endpoint>& e) { return e->transport == nullptr; }), endpoints.end());
+
+    flushExpired();
+    refreshEndpoints();
+    return ready;
+}
+
+void BusEventLoop::wake() {
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        std::cerr << "[BusEventLoop] Failed to wake loop: " << std::strerror(errno) << std::endl;
+    }
+}
+
+#endif // __linux__
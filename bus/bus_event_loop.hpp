@@ -0,0 +1,87 @@
+// bus_event_loop.hpp
+#pragma once
+#ifdef __linux__
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "bus_loop.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// Reactor-style loop that multiplexes every bus endpoint, tick timer and
+// shutdown signal on one epoll instance, so a single thread can service
+// dozens of PHC links. Ready endpoints are drained in bounded batches so one
+// chatty link cannot starve the others. Sends to packet-socket endpoints are
+// queued per endpoint under the BatchPolicy and handed to the transport's
+// sendBatch() together, which for a Unix socket link is one sendmmsg().
+class BusEventLoop : public BusLoop {
+public:
+    static constexpr int MAX_EVENTS = 64;
+
+    BusEventLoop();
+    ~BusEventLoop() override;
+
+    BusEventLoop(const BusEventLoop&) = delete;
+    BusEventLoop& operator=(const BusEventLoop&) = delete;
+
+    bool addViewEndpoint(BusTransport& transport, ViewHandler onView) override;
+    void removeEndpoint(BusTransport& transport) override;
+    void addFd(int fd, std::function<void()> onReady) override;
+    void removeFd(int fd) override;
+    int runOnce(int timeoutMs) override;
+    bool send(BusTransport& transport, const Message& msg) override;
+    void flush() override;
+
+    const char* backendName() const override { return "epoll"; }
+
+protected:
+    void wake() override;
+
+private:
+    struct Endpoint {
+        BusTransport* transport;
+        ViewHandler onMessage;
+        int fd;
+        uint32_t generation;
+        uint64_t watchId = 0;   // Of the handler installed for fd
+    };
+
+    // Descriptor numbers are reused as soon as they are closed, so each
+    // watch is told apart by an id as well
+    struct Watch {
+        std::function<void()> onReady;
+        uint64_t id;
+    };
+
+    // One endpoint's queued messages
+    struct OutBatch {
+        BusTransport* transport;
+        std::size_t count = 0;
+        std::chrono::steady_clock::time_point deadline{};
+        std::vector<Message> messages;
+    };
+
+    uint64_t watch(int fd, std::function<void()> onReady);     // 0 if fd could not be added
+    void forget(int fd, uint64_t id);
+    bool removed(int fd, uint64_t id) const;
+    void flushBatch(OutBatch& batch);
+    void flushExpired();
+    int clampToDeadlines(int timeoutMs) const;
+    void drain(Endpoint& endpoint);
+    void refreshEndpoints();
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    bool dispatching = false;
+    std::vector<std::pair<int, uint64_t>> deferredRemovals;
+    std::unordered_map<int, Watch> handlers;
+    uint64_t nextWatchId = 1;
+    std::vector<std::unique_ptr<Endpoint>> endpoints;
+    std::vector<std::unique_ptr<OutBatch>> outBatches;
+    std::chrono::steady_clock::time_point lastRefresh{};
+};
+
+#endif // __linux__
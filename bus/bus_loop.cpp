@@ -0,0 +1,130 @@
+// bus_loop.cpp
+#ifdef __linux__
+#include "bus_loop.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "bus_event_loop.hpp"
+#include "uring_event_loop.hpp"
+
+BusLoop::~BusLoop() {
+    for (int fd : ownedFds) {
+        close(fd);
+    }
+}
+
+bool BusLoop::addEndpoint(BusTransport& transport, MessageHandler onMessage) {
+    return addViewEndpoint(transport, [this, onMessage = std::move(onMessage)](const MessageView& view) {
+        Message msg;
+        if (view.materialize(msg)) {
+            onMessage(msg);
+        } else {
+            ++loopStats.dropped;
+        }
+    });
+}
+
+int BusLoop::addTimer(std::chrono::microseconds period, std::function<void(uint64_t)> onExpire) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("BusLoop: timerfd_create failed: " + std::string(std::strerror(errno)));
+    }
+
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(period.count() / 1000000);
+    spec.it_interval.tv_nsec = static_cast<long>((period.count() % 1000000) * 1000);
+    spec.it_value = spec.it_interval;
+    timerfd_settime(fd, 0, &spec, nullptr);
+
+    ownedFds.push_back(fd);
+    addFd(fd, [fd, onExpire = std::move(onExpire)] {
+        uint64_t expirations = 0;
+        if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+            onExpire(expirations);
+        }
+    });
+    return fd;
+}
+
+void BusLoop::removeTimer(int timer) {
+    auto it = std::find(ownedFds.begin(), ownedFds.end(), timer);
+    if (it == ownedFds.end()) {
+        return;
+    }
+    removeFd(timer);
+    close(timer);
+    ownedFds.erase(it);
+}
+
+void BusLoop::handleSignals(std::initializer_list<int> signals, std::function<void(int)> onSignal) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int sig : signals) {
+        sigaddset(&mask, sig);
+    }
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("BusLoop: signalfd failed: " + std::string(std::strerror(errno)));
+    }
+
+    ownedFds.push_back(fd);
+    addFd(fd, [fd, onSignal = std::move(onSignal)] {
+        signalfd_siginfo info;
+        while (read(fd, &info, sizeof(info)) == sizeof(info)) {
+            onSignal(static_cast<int>(info.ssi_signo));
+        }
+    });
+}
+
+void BusLoop::setBatchPolicy(const BatchPolicy& batching) {
+    policy = batching;
+    policy.maxMessages = std::clamp<std::size_t>(policy.maxMessages, 1, MAX_SEND_BATCH);
+    if (policy.window.count() <= 0) {
+        policy.window = std::chrono::microseconds{0};
+        policy.maxMessages = 1;
+    }
+}
+
+void BusLoop::run() {
+    running.store(true);
+    std::cout << "[BusLoop] Running " << backendName() << " loop" << std::endl;
+    while (running.load(std::memory_order_relaxed)) {
+        runOnce(static_cast<int>(REFRESH_INTERVAL.count()));
+    }
+    flush();
+    std::cout << "[BusLoop] Stopped after " << loopStats.wakeups << " wakeups, "
+              << loopStats.syscalls << " syscalls, " << loopStats.flushes << " send flushes" << std::endl;
+}
+
+void BusLoop::stop() {
+    running.store(false);
+    wake();
+}
+
+std::unique_ptr<BusLoop> makeBusLoop(BusBackend preferred) {
+#ifdef FIDGET_HAVE_IO_URING
+    if (preferred == BusBackend::IO_URING) {
+        try {
+            return std::make_unique<UringEventLoop>();
+        } catch (const std::exception& e) {
+            std::cerr << "[BusLoop] io_uring unavailable (" << e.what() << "), falling back to epoll" << std::endl;
+        }
+    }
+#else
+    if (preferred == BusBackend::IO_URING) {
+        std::cerr << "[BusLoop] Built without io_uring support, using epoll" << std::endl;
+    }
+#endif
+    return std::make_unique<BusEventLoop>();
+}
+
+#endif // __linux__
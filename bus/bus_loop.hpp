@@ -0,0 +1,135 @@
+// bus_loop.hpp
+#pragma once
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+#include "message_view.hpp"
+
+enum class BusBackend : uint8_t {
+    EPOLL,
+    IO_URING
+};
+
+// Single-threaded loop that services bus endpoints, tick timers and shutdown
+// signals. BusEventLoop (epoll) is always available; UringEventLoop batches
+// its syscalls through io_uring where the kernel supports it.
+class BusLoop {
+public:
+    static constexpr std::size_t MAX_BATCH = 64;   // Messages drained per endpoint per wakeup
+
+    using MessageHandler = std::function<void(const Message&)>;
+    using ViewHandler = std::function<void(const MessageView&)>;
+
+    struct Stats {
+        uint64_t wakeups = 0;     // Waits that returned events
+        uint64_t events = 0;      // Ready descriptors or completions dispatched
+        uint64_t messages = 0;    // Messages delivered to endpoint handlers
+        uint64_t syscalls = 0;    // Syscalls issued by the loop, including transport reads
+        uint64_t dropped = 0;     // Sends that failed
+        uint64_t flushes = 0;     // Batched sends handed to the kernel together
+        uint64_t flushedMessages = 0;
+        uint64_t largestFlush = 0; // Most messages carried by one flush
+    };
+
+    // Outbound batching per endpoint: queued sends go out together once
+    // maxMessages are waiting or the oldest has waited window, whichever is
+    // first, and at every flush(). A zero window sends each message at once.
+    struct BatchPolicy {
+        std::size_t maxMessages = 32;
+        std::chrono::microseconds window{1000};
+    };
+
+    BusLoop() = default;
+    virtual ~BusLoop();
+
+    BusLoop(const BusLoop&) = delete;
+    BusLoop& operator=(const BusLoop&) = delete;
+
+    // Deliver every message arriving on transport to onMessage. Returns false
+    // if the transport has no pollable descriptor yet; it is picked up once
+    // it connects.
+    bool addEndpoint(BusTransport& transport, MessageHandler onMessage);
+
+    // Same, but hand out views over the receive buffer instead of decoded
+    // copies; a view is valid only during the call
+    virtual bool addViewEndpoint(BusTransport& transport, ViewHandler onView) = 0;
+    virtual void removeEndpoint(BusTransport& transport) = 0;
+
+    // Raw descriptor, level-triggered
+    virtual void addFd(int fd, std::function<void()> onReady) = 0;
+    virtual void removeFd(int fd) = 0;
+
+    // Periodic timerfd; the callback receives the number of expirations.
+    // Returns an id for removeTimer().
+    int addTimer(std::chrono::microseconds period, std::function<void(uint64_t)> onExpire);
+    void removeTimer(int timer);
+
+    // Block the signals and deliver them through a signalfd instead
+    void handleSignals(std::initializer_list<int> signals, std::function<void(int)> onSignal);
+
+    // Send msg through transport. Must be called from the loop thread; a
+    // backend may hold the message until the next flush() or wait.
+    virtual bool send(BusTransport& transport, const Message& msg) {
+        if (transport.send(msg)) {
+            return true;
+        }
+        ++loopStats.dropped;
+        return false;
+    }
+
+    // Submit anything queued by send(). Called at each tick boundary.
+    virtual void flush() {}
+
+    // Takes effect for batches started after the call
+    void setBatchPolicy(const BatchPolicy& policy);
+    const BatchPolicy& batchPolicy() const { return policy; }
+
+    // Dispatch until stop() is called
+    void run();
+
+    // One wait plus dispatch. Returns the number of events handled.
+    virtual int runOnce(int timeoutMs) = 0;
+
+    // Safe to call from any thread or from a callback
+    void stop();
+
+    virtual const char* backendName() const = 0;
+
+    const Stats& stats() const { return loopStats; }
+
+protected:
+    // How often endpoints are checked for a descriptor change after a reconnect
+    static constexpr std::chrono::milliseconds REFRESH_INTERVAL{250};
+    static constexpr std::size_t MAX_SEND_BATCH = 256;
+
+    void countFlush(std::size_t messages) {
+        ++loopStats.flushes;
+        loopStats.flushedMessages += messages;
+        loopStats.largestFlush = std::max<uint64_t>(loopStats.largestFlush, messages);
+    }
+
+    // Interrupt a blocked runOnce() from any thread
+    virtual void wake() = 0;
+
+    Stats loopStats;
+    BatchPolicy policy;
+
+private:
+    std::atomic<bool> running{false};
+    std::vector<int> ownedFds;
+};
+
+// Build a loop for the preferred backend, falling back to epoll if io_uring
+// is unavailable at compile time or rejected by the running kernel
+std::unique_ptr<BusLoop> makeBusLoop(BusBackend preferred);
+
+#endif // __linux__
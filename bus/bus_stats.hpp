@@ -0,0 +1,206 @@
+// bus_stats.hpp
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "message_types.hpp"
+#include "symbol_table.hpp"
+
+// Monotonic clock used to stamp Message::enqueueNs
+inline uint64_t busClockNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Log-linear (HDR-style) latency buckets: values below 4 ns get their own
+// bucket, above that each power of two is split into 4 sub-buckets, giving
+// at most 25% relative error over the full 64-bit range.
+struct LatencyBuckets {
+    static constexpr std::size_t SUB_BUCKET_BITS = 2;
+    static constexpr std::size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr std::size_t COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    static std::size_t indexOf(uint64_t ns) {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<std::size_t>(ns);
+        }
+        std::size_t msb = std::bit_width(ns) - 1;
+        std::size_t shift = msb - SUB_BUCKET_BITS;
+        std::size_t sub = static_cast<std::size_t>(ns >> shift) & (SUB_BUCKETS - 1);
+        return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+    }
+
+    // Smallest value that falls in bucket index
+    static uint64_t lowerBound(std::size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        std::size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        std::size_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        return static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+    }
+};
+
+// Point-in-time copy of one route's counters
+struct RouteStats {
+    SymbolId from = NO_SYMBOL;
+    SymbolId to = NO_SYMBOL;
+    MessageType type = MessageType::NONE;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    std::array<uint64_t, LatencyBuckets::COUNT> buckets{};
+
+    // Approximate latency at quantile q (0..1), in nanoseconds
+    uint64_t percentileNs(double q) const {
+        if (messages == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(messages - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= target) {
+                return LatencyBuckets::lowerBound(i);
+            }
+        }
+        return 0;
+    }
+};
+
+// Per-route (from, to, type) latency histograms with message and byte
+// counters. Recording costs one relaxed atomic increment per message, the
+// message count being the histogram total, plus one for the byte counter
+// when the message arrived as a wire frame (Message::wireBytes); traffic
+// that never left the process adds no bytes. Routes claim a slot on first
+// use within MAX_PROBES of their hash; routes that find none, e.g. once the
+// table is full, are folded into a shared overflow slot.
+class BusStats {
+public:
+    static constexpr std::size_t MAX_ROUTES = 128;
+    static constexpr std::size_t MAX_PROBES = 8;
+
+    BusStats() : routes(std::make_unique<Route[]>(MAX_ROUTES + 1)) {}
+
+    // Record that msg was consumed at nowNs
+    void record(const Message& msg, uint64_t nowNs) {
+        uint64_t latency = nowNs > msg.enqueueNs ? nowNs - msg.enqueueNs : 0;
+        Route& route = routeFor(msg);
+        route.buckets[LatencyBuckets::indexOf(latency)].fetch_add(1, std::memory_order_relaxed);
+        if (msg.wireBytes != 0) {
+            route.bytes.fetch_add(msg.wireBytes, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<RouteStats> snapshot() const {
+        std::vector<RouteStats> result;
+        for (std::size_t i = 0; i <= MAX_ROUTES; ++i) {
+            uint64_t key = routes[i].key.load(std::memory_order_acquire);
+            if (key == EMPTY && i < MAX_ROUTES) {
+                continue;
+            }
+            RouteStats stats;
+            if (key != EMPTY) {
+                stats.from = static_cast<SymbolId>(key >> 24);
+                stats.to = static_cast<SymbolId>(key >> 8);
+                stats.type = static_cast<MessageType>(key & 0xFF);
+            }
+            for (std::size_t b = 0; b < LatencyBuckets::COUNT; ++b) {
+                stats.buckets[b] = routes[i].buckets[b].load(std::memory_order_relaxed);
+                stats.messages += stats.buckets[b];
+            }
+            if (stats.messages == 0) {
+                continue;
+            }
+            stats.bytes = routes[i].bytes.load(std::memory_order_relaxed);
+            result.push_back(stats);
+        }
+        return result;
+    }
+
+    // Zero all counters; route slots stay claimed
+    void reset() {
+        for (std::size_t i = 0; i <= MAX_ROUTES; ++i) {
+            for (auto& bucket : routes[i].buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            routes[i].bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // One line per route, e.g. for the debug console via std::cout
+    void dump(std::ostream& out) const {
+        out << "[BusStats] route                          msgs      bytes    p50(us)    p99(us)    max(us)\n";
+        for (const RouteStats& r : snapshot()) {
+            std::string route = symbols().name(r.from) + "->" + symbols().name(r.to) + " " + typeName(r.type);
+            out << "[BusStats] " << std::left << std::setw(30) << route << std::right
+                << std::setw(6) << r.messages
+                << std::setw(11) << r.bytes
+                << std::fixed << std::setprecision(1)
+                << std::setw(11) << r.percentileNs(0.50) / 1000.0
+                << std::setw(11) << r.percentileNs(0.99) / 1000.0
+                << std::setw(11) << r.percentileNs(1.0) / 1000.0 << "\n";
+        }
+    }
+
+    bool dumpToFile(const std::string& path) const {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        dump(file);
+        return true;
+    }
+
+    static const char* typeName(MessageType type) {
+        switch (type) {
+            case MessageType::BUTTON_PRESS: return "ButtonPress";
+            case MessageType::STATE_TRANSITION: return "StateTransition";
+            case MessageType::ANALOG_SAMPLE: return "AnalogSample";
+            default: return "Other";
+        }
+    }
+
+private:
+    static constexpr uint64_t EMPTY = 0;
+
+    struct alignas(64) Route {
+        std::atomic<uint64_t> key{EMPTY};
+        std::atomic<uint64_t> bytes{0};
+        std::array<std::atomic<uint64_t>, LatencyBuckets::COUNT> buckets{};
+    };
+
+    // from:16 | to:16 | type:8, plus a marker bit so no real key is EMPTY
+    static uint64_t keyOf(const Message& msg) {
+        return (uint64_t{1} << 40) | (uint64_t{msg.from} << 24) | (uint64_t{msg.to} << 8) |
+               static_cast<uint64_t>(msg.type);
+    }
+
+    Route& routeFor(const Message& msg) {
+        uint64_t key = keyOf(msg);
+        std::size_t start = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 57) % MAX_ROUTES;
+        // Bounded so a full table costs a few probes per message, not all of them
+        for (std::size_t probe = 0; probe < MAX_PROBES; ++probe) {
+            Route& route = routes[(start + probe) % MAX_ROUTES];
+            uint64_t current = route.key.load(std::memory_order_acquire);
+            if (current == key) {
+                return route;
+            }
+            if (current == EMPTY &&
+                (route.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || current == key)) {
+                return route;
+            }
+        }
+        return routes[MAX_ROUTES];
+    }
+
+    std::unique_ptr<Route[]> routes;
+};
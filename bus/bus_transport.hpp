@@ -0,0 +1,62 @@
+// bus_transport.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "message_types.hpp"
+#include "message_view.hpp"
+
+class BusCodec;
+
+// A point-to-point link that moves Messages between two processes.
+// PipeBusClient holds one (often shared through EndpointCache) and uses it
+// for all I/O.
+class BusTransport {
+public:
+    virtual ~BusTransport() = default;
+
+    // Non-blocking. Returns false if the message could not be queued.
+    virtual bool send(const Message& msg) = 0;
+
+    // Non-blocking. Sends msgs in order and stops at the first one that
+    // cannot be queued; returns how many were sent.
+    virtual std::size_t sendBatch(std::span<const Message> msgs) {
+        std::size_t sent = 0;
+        while (sent < msgs.size() && send(msgs[sent])) {
+            ++sent;
+        }
+        return sent;
+    }
+
+    // Non-blocking. Returns false if nothing is waiting.
+    virtual bool receive(Message& msg) = 0;
+
+    // Like receive(), but without copying the message out: the view stays
+    // valid until the next receive call on this transport. Transports that
+    // hold wire frames override this to view the frame in place.
+    virtual bool receiveView(MessageView& view) {
+        if (!receive(viewScratch)) {
+            return false;
+        }
+        view = MessageView(viewScratch);
+        return true;
+    }
+
+    // Block until a message may be available or timeoutMs elapses
+    virtual bool waitReadable(int timeoutMs) = 0;
+
+    // Descriptor that becomes readable when receive() may succeed, or -1 if
+    // the transport cannot be multiplexed
+    virtual int pollFd() const { return -1; }
+
+    // Changes whenever pollFd() is replaced by a reconnect
+    virtual uint32_t connectionGeneration() const { return 0; }
+
+    // Codec for pollFd() if it is a socket carrying exactly one encoded
+    // Message per packet, so an event loop may send and receive on it
+    // directly; nullptr otherwise
+    virtual BusCodec* packetCodec() { return nullptr; }
+
+protected:
+    Message viewScratch;    // Backs views handed out by receiveView()
+};
@@ -0,0 +1,92 @@
+// conflated_channel.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "symbol_table.hpp"
+
+// Latest reading of a conflated key
+struct ConflatedSample {
+    int32_t value = 0;
+    uint32_t dropped = 0; // Updates overwritten since the previous read
+    bool fresh = false;   // False if nothing was written since the previous read
+};
+
+// Latest-value store for analog inputs (THERM SET, PUMP SET sliders).
+// A write overwrites the pending value in place, so memory stays constant no
+// matter how fast a peripheral samples. Keys are registered at config load;
+// writes may come from any thread, reads from a single consumer thread.
+class ConflatedChannel {
+public:
+    explicit ConflatedChannel(std::size_t maxKeys)
+        : slots(std::make_unique<Slot[]>(maxKeys)), maxKeys(maxKeys) {
+        slotOf.assign(SymbolTable::MAX_SYMBOLS, NO_SLOT);
+    }
+
+    // Config load
+    void addKey(SymbolId key) {
+        if (slotOf[key] != NO_SLOT) {
+            return;
+        }
+        if (keyCount >= maxKeys) {
+            throw std::runtime_error("ConflatedChannel: too many keys");
+        }
+        slotOf[key] = static_cast<uint16_t>(keyCount++);
+    }
+
+    bool hasKey(SymbolId key) const {
+        return key < slotOf.size() && slotOf[key] != NO_SLOT;
+    }
+
+    // Returns false if key was never registered
+    bool write(SymbolId key, int32_t value) {
+        if (!hasKey(key)) {
+            return false;
+        }
+        // The write count and value share one word so readers never see a torn pair
+        std::atomic<uint64_t>& state = slots[slotOf[key]].state;
+        uint64_t current = state.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            next = ((current >> 32) + 1) << 32 | static_cast<uint32_t>(value);
+        } while (!state.compare_exchange_weak(current, next,
+                    std::memory_order_release, std::memory_order_relaxed));
+        return true;
+    }
+
+    // Consumer side
+    ConflatedSample read(SymbolId key) {
+        ConflatedSample sample;
+        if (!hasKey(key)) {
+            return sample;
+        }
+        Slot& slot = slots[slotOf[key]];
+        uint64_t state = slot.state.load(std::memory_order_acquire);
+        uint32_t writes = static_cast<uint32_t>(state >> 32);
+        sample.value = static_cast<int32_t>(static_cast<uint32_t>(state));
+        if (writes != slot.lastRead) {
+            sample.fresh = true;
+            sample.dropped = writes - slot.lastRead - 1;
+            slot.lastRead = writes;
+        }
+        return sample;
+    }
+
+    std::size_t size() const { return keyCount; }
+
+private:
+    static constexpr uint16_t NO_SLOT = 0xFFFF;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> state{0}; // write count << 32 | value
+        uint32_t lastRead = 0;          // Owned by the consumer
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::vector<uint16_t> slotOf;
+    std::size_t maxKeys;
+    std::size_t keyCount = 0;
+};
@@ -0,0 +1,58 @@
+// endpoint_cache.cpp
+#include "endpoint_cache.hpp"
+#include <iostream>
+#ifdef __linux__
+#include "uds_transport.hpp"
+#endif
+#ifdef _WIN32
+#include "named_pipe_transport.hpp"
+#endif
+
+std::shared_ptr<BusTransport> EndpointCache::acquire(const std::string& pipeName, WireFormat format) {
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    auto it = entries.find(pipeName);
+    if (it != entries.end()) {
+        if (it->second.format != format) {
+            std::cerr << "[EndpointCache] " << pipeName << " is already open as " << wireFormatName(it->second.format)
+                      << ", ignoring " << wireFormatName(format) << std::endl;
+        }
+        return it->second.transport;
+    }
+
+    std::shared_ptr<BusTransport> transport;
+#ifdef __linux__
+    transport = std::make_shared<UdsClientTransport>(pipeName, makeBusCodec(format));
+#elif defined(_WIN32)
+    transport = std::make_shared<NamedPipeClientTransport>(pipeName, makeBusCodec(format));
+#endif
+    if (transport) {
+        entries.emplace(pipeName, Entry{ transport, format });
+    }
+    return transport;
+}
+
+bool EndpointCache::send(const std::string& pipeName, const Message& msg) {
+    std::shared_ptr<BusTransport> transport;
+    {
+        // Use whatever format the connection was opened with
+        std::lock_guard<std::mutex> lock(entriesMutex);
+        auto it = entries.find(pipeName);
+        if (it != entries.end()) {
+            transport = it->second.transport;
+        }
+    }
+    if (!transport) {
+        transport = acquire(pipeName);
+    }
+    return transport && transport->send(msg);
+}
+
+void EndpointCache::clear() {
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    entries.clear();
+}
+
+std::size_t EndpointCache::size() const {
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    return entries.size();
+}
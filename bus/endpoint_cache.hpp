@@ -0,0 +1,47 @@
+// endpoint_cache.hpp
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "bus_codec.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// Client connections to named bus endpoints, opened on first use and kept
+// for the life of the process. Transports reconnect lazily on their own
+// after a failure, so a cached entry never needs replacing. PinSim,
+// emitPinState and PipeBusClient all go through here, so one pipe name
+// means one connection however many writers share it.
+class EndpointCache {
+public:
+    // Connection to pipeName (UdsClientTransport on Linux, named pipe client
+    // on Windows), created with the given wire format on first use. Later
+    // calls return the same transport; a different format is ignored with
+    // a warning.
+    std::shared_ptr<BusTransport> acquire(const std::string& pipeName, WireFormat format = WireFormat::BINARY);
+
+    // Send through the cached connection to pipeName, opening a binary one
+    // if there is none yet. Safe from any thread.
+    bool send(const std::string& pipeName, const Message& msg);
+
+    // Close every cached connection
+    void clear();
+
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<BusTransport> transport;
+        WireFormat format;
+    };
+
+    mutable std::mutex entriesMutex;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+// Process-wide endpoint cache
+inline EndpointCache& endpointCache() {
+    static EndpointCache cache;
+    return cache;
+}
@@ -0,0 +1,107 @@
+// lane_queue.hpp
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "message_types.hpp"
+#include "spsc_ring.hpp"
+
+// Per-lane capacity limits
+struct LaneCapacities {
+    std::size_t safety = 64;
+    std::size_t control = 256;
+    std::size_t telemetry = 256;
+
+    std::size_t operator[](Lane lane) const {
+        switch (lane) {
+            case Lane::SAFETY: return safety;
+            case Lane::CONTROL: return control;
+            default: return telemetry;
+        }
+    }
+};
+
+// Depth counters for one lane
+struct LaneStats {
+    std::size_t depth = 0;      // Messages currently queued
+    std::size_t highWater = 0;  // Deepest the queue has been when drained
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;       // Rejected because the lane was full
+};
+
+inline std::size_t laneIndex(Lane lane) {
+    return static_cast<std::size_t>(lane);
+}
+
+// One SPSC ring per priority lane. The producer pushes into the lane named in
+// the message header; the consumer always drains SAFETY before CONTROL before
+// TELEMETRY, so a full routine lane can never delay a safety message.
+class LanedQueue {
+public:
+    explicit LanedQueue(const LaneCapacities& capacities) {
+        for (std::size_t i = 0; i < LANE_COUNT; ++i) {
+            rings[i] = std::make_unique<SpscRing<Message>>(capacities[static_cast<Lane>(i)]);
+        }
+    }
+
+    // Producer side
+    bool tryPush(const Message& msg) {
+        std::size_t i = laneIndex(msg.lane);
+        if (!rings[i]->tryPush(msg)) {
+            dropped[i].fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // Consumer side. Pops from the highest-priority non-empty lane.
+    bool tryPop(Message& msg) {
+        for (std::size_t i = 0; i < LANE_COUNT; ++i) {
+            if (tryPop(static_cast<Lane>(i), msg)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Consumer side. Pops from one lane only.
+    bool tryPop(Lane lane, Message& msg) {
+        std::size_t i = laneIndex(lane);
+        std::size_t depth = rings[i]->size();
+        if (depth > highWater[i]) {
+            highWater[i] = depth;
+        }
+        if (!rings[i]->tryPop(msg)) {
+            return false;
+        }
+        ++delivered[i];
+        return true;
+    }
+
+    // Consumer side
+    LaneStats stats(Lane lane) const {
+        std::size_t i = laneIndex(lane);
+        LaneStats s;
+        s.depth = rings[i]->size();
+        s.highWater = highWater[i];
+        s.delivered = delivered[i];
+        s.dropped = dropped[i].load(std::memory_order_relaxed);
+        return s;
+    }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& ring : rings) {
+            total += ring->size();
+        }
+        return total;
+    }
+
+private:
+    std::array<std::unique_ptr<SpscRing<Message>>, LANE_COUNT> rings;
+    std::array<std::atomic<uint64_t>, LANE_COUNT> dropped{};
+    std::array<std::size_t, LANE_COUNT> highWater{};
+    std::array<uint64_t, LANE_COUNT> delivered{};
+};
@@ -1,27 +1,303 @@
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
 #include <vector>
+#include "bus_stats.hpp"
+#include "conflated_channel.hpp"
+#include "lane_queue.hpp"
+#include "message_registry.hpp"
 #include "message_types.hpp"
+#include "routing_table.hpp"
+#include "tick_mailbox.hpp"
+#include "type_batches.hpp"
 
 
+// Where MessageBus hands a message to its tap
+enum class TapPoint : uint8_t {
+    INBOUND,    // Transport traffic entering a tick's inbound view
+    ANALOG,     // Fresh conflated value read by the tick
+    OUTBOUND    // Queued by the tick for the transport
+};
+
+// Observer for everything crossing the tick boundary, e.g. a trace
+// recorder. Called on the tick thread with the tick that observed or
+// produced the message; must not block.
+class BusTap {
+public:
+    virtual ~BusTap() = default;
+    virtual void onMessage(const Message& msg, TapPoint point, uint32_t tick) = 0;
+};
+
+// Inbound traffic is pushed by the transport (I/O) thread and drained by the
+// tick thread; outbound traffic flows the other way. Each direction is a set
+// of fixed-capacity SPSC rings, one per priority lane, so neither side locks
+// or allocates and SAFETY traffic is always drained first.
+//
+// On the tick thread, inbound messages are read through a double-buffered
+// mailbox: everything received or posted during tick N is visible, unchanged,
+// through getInbound() for the whole of tick N+1.
+//
+// Once routes are built, each swap also fans the front buffer out into dense
+// per-subscriber inboxes, so consumers only see messages addressed to them.
+//
+// AnalogSample traffic for registered channels bypasses the queues entirely:
+// it lands in a conflated channel that keeps only the newest value per key.
+//
+// Every message is stamped when queued and recorded in per-route latency
+// histograms when consumed (inbound at the tick swap, outbound when popped).
 class MessageBus {
 public:
-    void pushInbound(const Message& msg) {
-        inbound.push_back(msg);
+    static constexpr std::size_t MAX_ANALOG_CHANNELS = 32;
+
+    explicit MessageBus(const LaneCapacities& capacities = LaneCapacities{})
+        : inbound(capacities), outbound(capacities), mailbox(capacities),
+          analog(MAX_ANALOG_CHANNELS),
+          totalCapacity(capacities.safety + capacities.control + capacities.telemetry),
+          batches(totalCapacity) {
+        laneOverrides.fill(NO_OVERRIDE);
+        signals.fill(NO_SYMBOL);
+    }
+
+    // Config load. Register subscriptions here, then call buildRoutes().
+    RoutingTable& routes() { return routing; }
+
+    // Freeze the routing table and preallocate one inbox per subscriber
+    void buildRoutes() {
+        routing.build();
+        inboxes.assign(routing.subscriberCount(), {});
+        for (auto& inbox : inboxes) {
+            inbox.reserve(totalCapacity);
+        }
+    }
+
+    // Config load. Route every message keyed by symbol (the button's signal
+    // for a ButtonPress, otherwise the sender) into the given lane.
+    void assignLane(SymbolId key, Lane lane) {
+        if (key < laneOverrides.size()) {
+            laneOverrides[key] = static_cast<uint8_t>(lane);
+        }
+    }
+
+    // Config load. pin is wired to the logical signal (phc_a:PB1 to SCRAM).
+    // Its presses are laned by the signal, and one sent without a
+    // destination is addressed to it, so listen_for and priority_lanes can
+    // name signals rather than pins.
+    void addSignal(SymbolId pin, SymbolId signal) {
+        if (pin < signals.size()) {
+            signals[pin] = signal;
+        }
+    }
+
+    // Config load. Conflate AnalogSample traffic for this channel.
+    void addAnalogChannel(SymbolId channel) {
+        analog.addKey(channel);
+    }
+
+    // I/O thread. Returns false (and drops the message) if its lane is full
+    bool pushInbound(const Message& msg) {
+        if (conflate(msg)) {
+            return true;
+        }
+        return inbound.tryPush(prepare(msg));
+    }
+
+    // Tick thread. Queue a message for next tick's inbound view.
+    bool post(const Message& msg) {
+        if (conflate(msg)) {
+            return true;
+        }
+        Message stamped = prepare(msg);
+        stamped.tick = currentTick;
+        return mailbox.post(stamped);
+    }
+
+    // Tick thread. Returns false (and drops the message) if its lane is full
+    bool emitOutbound(const Message& msg) {
+        Message prepared = prepare(msg);
+        if (tap) {
+            tap->onMessage(prepared, TapPoint::OUTBOUND, currentTick);
+        }
+        return outbound.tryPush(prepared);
+    }
+
+    // I/O thread. Always yields SAFETY traffic first.
+    bool popOutbound(Message& msg) {
+        if (!outbound.tryPop(msg)) {
+            return false;
+        }
+        if (instrumented) {
+            busStats.record(msg, busClockNs());
+        }
+        return true;
+    }
+
+    // Tick boundary: move pending inbound traffic into the back buffer, lane
+    // by lane in priority order, and flip it to the front. Anything that
+    // does not fit stays queued in its ring for the next tick.
+    void swapBuffers() {
+        Message msg;
+        for (std::size_t i = 0; i < LANE_COUNT; ++i) {
+            Lane lane = static_cast<Lane>(i);
+            while (!mailbox.backFull(lane) && inbound.tryPop(lane, msg)) {
+                msg.tick = currentTick;
+                if (tap) {
+                    tap->onMessage(msg, TapPoint::INBOUND, currentTick + 1);
+                }
+                mailbox.post(msg);
+            }
+        }
+        mailbox.swap();
+        ++currentTick;
+
+        if (instrumented) {
+            uint64_t now = busClockNs();
+            forEachInbound([this, now](const Message& front) { busStats.record(front, now); });
+        }
+
+        if (routing.isBuilt()) {
+            routeFront();
+        }
+    }
+
+    // Messages routed to subscriber this tick, in priority order
+    std::span<const Message* const> inbox(SubscriberId subscriber) const {
+        return inboxes[subscriber];
     }
 
-    void emitOutbound(const Message& msg) {
-        outbound.push_back(msg);
+    // Any thread. Overwrite the pending value for an analog channel.
+    bool publishAnalog(SymbolId channel, int32_t value) {
+        return analog.write(channel, value);
     }
 
-    const std::vector<Message>& getInbound() const { return inbound; }
-    const std::vector<Message>& getOutbound() const { return outbound; }
+    // Tick thread. Latest value plus the number of updates it superseded.
+    ConflatedSample readAnalog(SymbolId channel) {
+        ConflatedSample sample = analog.read(channel);
+        if (tap && sample.fresh) {
+            tap->onMessage(Message::make(channel, NO_SYMBOL, AnalogSample{ channel, sample.value }),
+                           TapPoint::ANALOG, currentTick);
+        }
+        return sample;
+    }
+
+    // Stable for the duration of the current tick
+    std::span<const Message> getInbound(Lane lane) const { return mailbox.front(lane); }
+
+    // Visit this tick's inbound messages in strict priority order
+    template <typename Fn>
+    void forEachInbound(Fn&& fn) const {
+        for (std::size_t i = 0; i < LANE_COUNT; ++i) {
+            for (const Message& msg : mailbox.front(static_cast<Lane>(i))) {
+                fn(msg);
+            }
+        }
+    }
 
-    void clear() {
-        inbound.clear();
-        outbound.clear();
+    // Dispatch this tick's inbound messages, in priority order, to one handler
+    // per payload type, e.g. bus.dispatch([](const ButtonPress&) {...}, ...)
+    template <typename... Handlers>
+    void dispatch(Handlers&&... handlers) const {
+        auto dispatcher = makeDispatcher(std::forward<Handlers>(handlers)...);
+        forEachInbound(dispatcher);
     }
 
+    // As dispatch(), restricted to the messages routed to subscriber
+    template <typename... Handlers>
+    void dispatchInbox(SubscriberId subscriber, Handlers&&... handlers) const {
+        auto dispatcher = makeDispatcher(std::forward<Handlers>(handlers)...);
+        for (const Message* msg : inboxes[subscriber]) {
+            dispatcher(*msg);
+        }
+    }
+
+    // Partition this tick's inbound messages by payload type for batch
+    // consumers. Valid until the next swapBuffers().
+    const TypeBatches& partitionInbound() {
+        batches.partition([this](auto&& fn) { forEachInbound(fn); });
+        return batches;
+    }
+
+    std::size_t inboundCount() const { return mailbox.frontSize(); }
+
+    LaneStats inboundStats(Lane lane) const { return inbound.stats(lane); }
+    LaneStats outboundStats(Lane lane) const { return outbound.stats(lane); }
+
+    // Per-route latency and throughput; snapshot(), reset(), dump()
+    BusStats& stats() { return busStats; }
+    const BusStats& stats() const { return busStats; }
+
+    void setInstrumented(bool enabled) { instrumented = enabled; }
+
+    // Tick thread, between ticks. Null removes the tap.
+    void setTap(BusTap* observer) { tap = observer; }
+
+    uint32_t tick() const { return currentTick; }
+    std::size_t pendingInbound() const { return inbound.size(); }
+    std::size_t outboundSize() const { return outbound.size(); }
+
 private:
-    std::vector<Message> inbound;
-    std::vector<Message> outbound;
+    static constexpr uint8_t NO_OVERRIDE = 0xFF;
+
+    Message classify(const Message& msg) const {
+        Message routed = msg;
+        SymbolId key = msg.from;
+        if (msg.isButtonPress()) {
+            // An unwired button is its own signal
+            key = msg.getButtonPress().button_id;
+            if (key < signals.size() && signals[key] != NO_SYMBOL) {
+                key = signals[key];
+            }
+            if (routed.to == NO_SYMBOL) {
+                routed.to = key;
+            }
+        }
+        if (key < laneOverrides.size() && laneOverrides[key] != NO_OVERRIDE) {
+            routed.lane = static_cast<Lane>(laneOverrides[key]);
+        }
+        return routed;
+    }
+
+    Message prepare(const Message& msg) const {
+        Message prepared = classify(msg);
+        if (instrumented) {
+            prepared.enqueueNs = busClockNs();
+        }
+        return prepared;
+    }
+
+    bool conflate(const Message& msg) {
+        if (!msg.isAnalogSample()) {
+            return false;
+        }
+        return analog.write(msg.getAnalogSample().channel, msg.getAnalogSample().value);
+    }
+
+    // Capacity was reserved in buildRoutes(), so push_back never reallocates
+    void routeFront() {
+        for (auto& inbox : inboxes) {
+            inbox.clear();
+        }
+        forEachInbound([this](const Message& msg) {
+            for (SubscriberId subscriber : routing.subscribersFor(msg.to, msg.type)) {
+                inboxes[subscriber].push_back(&msg);
+            }
+        });
+    }
+
+    LanedQueue inbound;
+    LanedQueue outbound;
+    TickMailbox mailbox;
+    ConflatedChannel analog;
+    RoutingTable routing;
+    std::vector<std::vector<const Message*>> inboxes;
+    std::size_t totalCapacity;
+    TypeBatches batches;
+    std::array<uint8_t, SymbolTable::MAX_SYMBOLS> laneOverrides;
+    std::array<SymbolId, SymbolTable::MAX_SYMBOLS> signals;     // Wired pin to its signal
+    BusStats busStats;
+    bool instrumented = true;
+    BusTap* tap = nullptr;
+    uint32_t currentTick = 0;
 };
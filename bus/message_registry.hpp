@@ -0,0 +1,139 @@
+// message_registry.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "message_types.hpp"
+
+// Compile-time registry of payload types. Each payload is bound to its
+// MessageType tag and union member here; adding a payload means adding a
+// PayloadTraits specialization and listing it in RegisteredPayloads.
+template <typename T>
+struct PayloadTraits; // Left undefined: unregistered types fail to compile
+
+template <>
+struct PayloadTraits<ButtonPress> {
+    static constexpr MessageType type = MessageType::BUTTON_PRESS;
+    static const ButtonPress& get(const Message& msg) { return msg.payload.buttonPress; }
+    static void set(Message& msg, const ButtonPress& value) { msg.type = type; msg.payload.buttonPress = value; }
+    template <typename F>
+    static void forEachSymbol(Message& msg, F&& f) { f(msg.payload.buttonPress.button_id); }
+};
+
+template <>
+struct PayloadTraits<StateTransition> {
+    static constexpr MessageType type = MessageType::STATE_TRANSITION;
+    static const StateTransition& get(const Message& msg) { return msg.payload.stateTransition; }
+    static void set(Message& msg, const StateTransition& value) { msg.type = type; msg.payload.stateTransition = value; }
+    template <typename F>
+    static void forEachSymbol(Message&, F&&) {}
+};
+
+template <>
+struct PayloadTraits<AnalogSample> {
+    static constexpr MessageType type = MessageType::ANALOG_SAMPLE;
+    static const AnalogSample& get(const Message& msg) { return msg.payload.analogSample; }
+    static void set(Message& msg, const AnalogSample& value) { msg.type = type; msg.payload.analogSample = value; }
+    template <typename F>
+    static void forEachSymbol(Message& msg, F&& f) { f(msg.payload.analogSample.channel); }
+};
+
+template <typename... Ts>
+struct PayloadList {
+    static constexpr std::size_t size = sizeof...(Ts);
+};
+
+using RegisteredPayloads = PayloadList<ButtonPress, StateTransition, AnalogSample>;
+
+// constexpr id of a payload type, usable as an array index
+template <typename T>
+inline constexpr std::size_t payloadId = static_cast<std::size_t>(PayloadTraits<T>::type);
+
+namespace detail {
+
+    template <typename... Ts>
+    constexpr bool coversAllTypes(PayloadList<Ts...>) {
+        // Every non-NONE tag must be claimed by exactly one payload
+        std::array<int, MESSAGE_TYPE_COUNT> claims{};
+        ((++claims[payloadId<Ts>]), ...);
+        if (claims[static_cast<std::size_t>(MessageType::NONE)] != 0) return false;
+        for (std::size_t i = 1; i < MESSAGE_TYPE_COUNT; ++i) {
+            if (claims[i] != 1) return false;
+        }
+        return true;
+    }
+
+    template <typename... Fs>
+    struct Overloaded : Fs... {
+        using Fs::operator()...;
+    };
+
+    template <typename... Fs>
+    Overloaded(Fs...) -> Overloaded<Fs...>;
+
+    // One case per registered payload, expanded at compile time. The compiler
+    // lowers it to a switch on the tag with every handler inlined, which
+    // bench/dispatch_bench.cpp measured faster than a table of function
+    // pointers (no indirect call, nothing hidden from the inliner).
+    template <typename Visitor, typename... Ts>
+    void dispatchByTag(PayloadList<Ts...>, Visitor& visitor, const Message& msg) {
+        ((msg.type == PayloadTraits<Ts>::type ? (visitor(PayloadTraits<Ts>::get(msg)), true) : false) || ...);
+    }
+
+    template <typename Visitor, typename... Ts>
+    constexpr bool handlesAll(PayloadList<Ts...>) {
+        return (std::is_invocable_v<Visitor&, const Ts&> && ...);
+    }
+
+    template <typename F, typename... Ts>
+    void forEachPayloadSymbol(PayloadList<Ts...>, Message& msg, F& f) {
+        ((msg.type == PayloadTraits<Ts>::type ? (PayloadTraits<Ts>::forEachSymbol(msg, f), true) : false) || ...);
+    }
+
+} // namespace detail
+
+static_assert(detail::coversAllTypes(RegisteredPayloads{}),
+    "RegisteredPayloads must register exactly one payload per MessageType");
+
+// Dispatches messages to a set of handlers, one per registered payload type,
+// through a switch on the message type tag generated from the registry. No
+// RTTI, no std::function, and a missing handler is a compile-time error.
+// Messages with no payload (NONE) are ignored.
+template <typename Visitor>
+class MessageDispatcher {
+public:
+    static_assert(detail::handlesAll<Visitor>(RegisteredPayloads{}),
+        "MessageDispatcher: a handler is required for every registered payload type");
+
+    explicit MessageDispatcher(Visitor visitor) : visitor(std::move(visitor)) {}
+
+    void operator()(const Message& msg) {
+        detail::dispatchByTag(RegisteredPayloads{}, visitor, msg);
+    }
+
+private:
+    Visitor visitor;
+};
+
+// Build a dispatcher from one lambda per payload type
+template <typename... Handlers>
+auto makeDispatcher(Handlers&&... handlers) {
+    using Visitor = detail::Overloaded<std::decay_t<Handlers>...>;
+    return MessageDispatcher<Visitor>(Visitor{ std::forward<Handlers>(handlers)... });
+}
+
+// Dispatch a single message
+template <typename... Handlers>
+void dispatchMessage(const Message& msg, Handlers&&... handlers) {
+    makeDispatcher(std::forward<Handlers>(handlers)...)(msg);
+}
+
+// Apply f(SymbolId&) to every symbol a message carries, header and payload,
+// e.g. to translate ids between processes that intern names differently
+template <typename F>
+void forEachSymbol(Message& msg, F&& f) {
+    f(msg.from);
+    f(msg.to);
+    detail::forEachPayloadSymbol(RegisteredPayloads{}, msg, f);
+}
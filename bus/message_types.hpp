@@ -1,31 +1,135 @@
 #pragma once
-#include <string>
-#include <variant>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "symbol_table.hpp"
+
+// Payload type tag carried in every message header
+enum class MessageType : uint8_t {
+    NONE = 0,
+    BUTTON_PRESS,
+    STATE_TRANSITION,
+    ANALOG_SAMPLE
+};
+
+inline constexpr std::size_t MESSAGE_TYPE_COUNT = 4;
+
+// Priority lane a message travels in; lower values are drained first
+enum class Lane : uint8_t {
+    SAFETY = 0,   // SCRAM and other trips, never waits behind routine traffic
+    CONTROL,      // Operator input and state changes
+    TELEMETRY     // Readouts that can tolerate delay or loss
+};
+
+inline constexpr std::size_t LANE_COUNT = 3;
+
+// Payload structs are trivial so they can live in the Message payload union
 
 // Define the ButtonPress message
 struct ButtonPress {
-    std::string button_id;
+    SymbolId button_id;
     bool pressed;
 };
 
-// Define the Message structure
+// Emitted by the power state machine when the controller changes phase
+struct StateTransition {
+    uint8_t phase; // ControllerState::Phase
+};
+
+// A potentiometer reading; delivered through a conflated channel, not a queue
+struct AnalogSample {
+    SymbolId channel;
+    int32_t value;
+};
+
+// Fixed-size, trivially-copyable message record. The header is followed by an
+// inline payload union, so a Message can be memcpy'd into rings, shared memory
+// and trace files as-is.
 struct Message {
-    std::string from;
-    std::string to;
+    static constexpr std::size_t PAYLOAD_SIZE = 8;
+
+    // Header
+    MessageType type = MessageType::NONE;
+    uint8_t flags = 0;
+    SymbolId from = NO_SYMBOL; // Interned endpoint names, see symbols().name()
+    SymbolId to = NO_SYMBOL;
+    Lane lane = Lane::CONTROL;
+    uint8_t wireBytes = 0;     // Frame size when decoded off the wire, else 0
+    uint32_t tick = 0;         // Controller tick the message was produced in
+    uint32_t seq = 0;          // Per-producer sequence number
+    uint64_t enqueueNs = 0;    // Bus clock when queued, for latency stats
+
+    // Payload, selected by type
+    union Payload {
+        uint8_t raw[PAYLOAD_SIZE] = {};
+        ButtonPress buttonPress;
+        StateTransition stateTransition;
+        AnalogSample analogSample;
+    } payload;
+
+    static Message make(SymbolId from, SymbolId to, const ButtonPress& press) {
+        Message msg;
+        msg.type = MessageType::BUTTON_PRESS;
+        msg.from = from;
+        msg.to = to;
+        msg.payload.buttonPress = press;
+        return msg;
+    }
+
+    static Message make(SymbolId from, SymbolId to, const StateTransition& transition) {
+        Message msg;
+        msg.type = MessageType::STATE_TRANSITION;
+        msg.from = from;
+        msg.to = to;
+        msg.payload.stateTransition = transition;
+        return msg;
+    }
 
-    // Use a variant to represent the payload
-    std::variant<ButtonPress> payload;
+    static Message make(SymbolId from, SymbolId to, const AnalogSample& sample) {
+        Message msg;
+        msg.type = MessageType::ANALOG_SAMPLE;
+        msg.from = from;
+        msg.to = to;
+        msg.lane = Lane::TELEMETRY;
+        msg.payload.analogSample = sample;
+        return msg;
+    }
 
     // Helper methods for working with the payload
     bool isButtonPress() const {
-        return std::holds_alternative<ButtonPress>(payload);
+        return type == MessageType::BUTTON_PRESS;
     }
 
     const ButtonPress& getButtonPress() const {
-        return std::get<ButtonPress>(payload);
+        return payload.buttonPress;
     }
 
     ButtonPress& getButtonPress() {
-        return std::get<ButtonPress>(payload);
+        return payload.buttonPress;
+    }
+
+    bool isStateTransition() const {
+        return type == MessageType::STATE_TRANSITION;
+    }
+
+    const StateTransition& getStateTransition() const {
+        return payload.stateTransition;
+    }
+
+    bool isAnalogSample() const {
+        return type == MessageType::ANALOG_SAMPLE;
     }
-};
\ No newline at end of file
+
+    const AnalogSample& getAnalogSample() const {
+        return payload.analogSample;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<Message>, "Message must be memcpy-able");
+static_assert(std::is_standard_layout_v<Message>, "Message layout must be stable across processes");
+static_assert(sizeof(Message) == 32, "Message must stay 32 bytes");
+static_assert(alignof(Message) <= 8, "Message must not require over-alignment");
+static_assert(offsetof(Message, payload) == 24, "Message header must be 24 bytes");
+static_assert(sizeof(ButtonPress) <= Message::PAYLOAD_SIZE, "ButtonPress does not fit inline");
+static_assert(sizeof(StateTransition) <= Message::PAYLOAD_SIZE, "StateTransition does not fit inline");
+static_assert(sizeof(AnalogSample) <= Message::PAYLOAD_SIZE, "AnalogSample does not fit inline");
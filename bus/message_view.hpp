@@ -0,0 +1,135 @@
+// message_view.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "message_registry.hpp"
+#include "message_types.hpp"
+#include "wire_format.hpp"
+
+// Non-owning, read-only view of a received message. Over a binary wire frame
+// it reads straight from the receive buffer: parse() checks only the fixed
+// header (length, version, CRC, type, lane) and each accessor decodes its
+// field on demand, so a handler that looks at type() and one payload field
+// never decodes the rest. Transports using another codec hand out views
+// over an already-decoded Message instead.
+//
+// A view is only valid inside the handler it was passed to; the buffer
+// behind it is reused for the next packet. Call materialize() to keep a copy.
+class MessageView {
+public:
+    MessageView() = default;
+    explicit MessageView(const Message& msg) : decoded(&msg) {}
+
+    // View the single frame filling packet. Body fields that turn out to be
+    // malformed read as zero and make materialize() fail.
+    static WireStatus parse(std::span<const uint8_t> packet, MessageView& view) {
+        std::size_t frameSize = peekFrameSize(packet);
+        if (frameSize == 0 || frameSize != packet.size() || frameSize > MAX_FRAME_SIZE ||
+            frameSize < WIRE_LENGTH_BYTES + 3) {
+            return WireStatus::BAD_LENGTH;
+        }
+        const uint8_t* body = packet.data() + WIRE_LENGTH_BYTES;
+        const uint8_t* end = packet.data() + frameSize;
+        if ((body[0] >> 4) != WIRE_VERSION) {
+            return WireStatus::BAD_VERSION;
+        }
+        if (body[0] & WIRE_FLAG_CRC) {
+            if (end - body < 4 + 3) {
+                return WireStatus::BAD_LENGTH;
+            }
+            end -= 4;
+            uint32_t expected = static_cast<uint32_t>(end[0]) | (static_cast<uint32_t>(end[1]) << 8) |
+                                (static_cast<uint32_t>(end[2]) << 16) | (static_cast<uint32_t>(end[3]) << 24);
+            if (detail::crc32c(body, static_cast<std::size_t>(end - body)) != expected) {
+                return WireStatus::BAD_CRC;
+            }
+        }
+        if (body[1] >= MESSAGE_TYPE_COUNT || body[2] >= LANE_COUNT) {
+            return WireStatus::BAD_TYPE;
+        }
+
+        view = MessageView{};
+        view.frame = packet;
+        view.fields = body + 3;
+        view.end = end;
+        return WireStatus::OK;
+    }
+
+    MessageType type() const {
+        return decoded ? decoded->type : static_cast<MessageType>(frame[WIRE_LENGTH_BYTES + 1]);
+    }
+
+    Lane lane() const {
+        return decoded ? decoded->lane : static_cast<Lane>(frame[WIRE_LENGTH_BYTES + 2]);
+    }
+
+    SymbolId from() const { return decoded ? decoded->from : static_cast<SymbolId>(field(0)); }
+    SymbolId to() const { return decoded ? decoded->to : static_cast<SymbolId>(field(1)); }
+    uint32_t seq() const { return decoded ? decoded->seq : field(2); }
+
+    template <typename T>
+    bool is() const { return type() == PayloadTraits<T>::type; }
+
+    // Decode the payload as T. Returns a value-initialized T if the message
+    // carries a different payload or its bytes are malformed.
+    template <typename T>
+    T payload() const {
+        T value{};
+        if (!is<T>()) {
+            return value;
+        }
+        if (decoded) {
+            return PayloadTraits<T>::get(*decoded);
+        }
+        const uint8_t* p = skipFields(3);
+        if (!p || !WireCodec<T>::decode(p, end, value)) {
+            return T{};
+        }
+        return value;
+    }
+
+    // Owning copy. Returns false if the frame body is malformed.
+    bool materialize(Message& out) const {
+        if (decoded) {
+            out = *decoded;
+            return true;
+        }
+        WireDecodeResult result = decodeFrame(frame, out);
+        return result.status == WireStatus::OK;
+    }
+
+    // Raw frame behind the view; empty for views over a decoded Message
+    std::span<const uint8_t> bytes() const { return frame; }
+
+private:
+    // Start of the header varint after skipping count of them, or nullptr.
+    // A varint ends at the first byte without the continuation bit, so
+    // skipping one needs no decoding.
+    const uint8_t* skipFields(int count) const {
+        const uint8_t* p = fields;
+        while (count > 0) {
+            if (p == end) {
+                return nullptr;
+            }
+            if (!(*p++ & 0x80)) {
+                --count;
+            }
+        }
+        return p;
+    }
+
+    uint32_t field(int index) const {
+        const uint8_t* p = skipFields(index);
+        uint32_t value = 0;
+        if (!p || !detail::getVarint(p, end, value)) {
+            return 0;
+        }
+        return value;
+    }
+
+    const Message* decoded = nullptr;
+    std::span<const uint8_t> frame;
+    const uint8_t* fields = nullptr;    // First header varint (from)
+    const uint8_t* end = nullptr;       // End of payload, before any CRC
+};
@@ -0,0 +1,80 @@
+// mpsc_ring.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "spsc_ring.hpp"
+
+// Fixed-capacity, lock-free multi-producer/single-consumer ring (bounded
+// Vyukov queue). Each slot carries a sequence number: producers claim a slot
+// with one CAS on the head and publish it by bumping its sequence, so they
+// never wait on each other's copies. Any number of threads may call tryPush;
+// exactly one thread may call tryPop.
+template <typename T>
+class MpscRing {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit MpscRing(std::size_t capacity)
+        : mask(roundUpPow2(capacity) - 1),
+          slots(std::make_unique<Slot[]>(mask + 1)) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Producer side. Returns false if the ring is full.
+    bool tryPush(const T& item) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[h & mask];
+            auto lag = static_cast<std::ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - h);
+            if (lag == 0) {
+                if (head.compare_exchange_weak(h, h + 1, std::memory_order_relaxed)) {
+                    slot.value = item;
+                    slot.sequence.store(h + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // Consumer has not freed this slot yet
+            } else {
+                h = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side. Returns false if the ring is empty or the next slot is
+    // claimed but not yet published.
+    bool tryPop(T& out) {
+        Slot& slot = slots[tail & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        out = std::move(slot.value);
+        slot.sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(kCacheLineSize) std::atomic<std::size_t> head{0};  // claimed by producers
+    alignas(kCacheLineSize) std::size_t tail = 0;              // owned by the consumer
+};
@@ -0,0 +1,120 @@
+// named_pipe_transport.cpp
+#ifdef _WIN32
+#include "named_pipe_transport.hpp"
+#include <iostream>
+#include <thread>
+
+NamedPipeClientTransport::NamedPipeClientTransport(const std::string& pipeName, std::unique_ptr<BusCodec> codec)
+    : pipePath("\\\\.\\pipe\\" + pipeName), codec(codec ? std::move(codec) : std::make_unique<BinaryCodec>()) {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    ensureConnected();
+}
+
+NamedPipeClientTransport::~NamedPipeClientTransport() {
+    disconnect();
+}
+
+bool NamedPipeClientTransport::ensureConnected() {
+    if (pipe != INVALID_HANDLE_VALUE) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastAttempt < RECONNECT_INTERVAL) {
+        return false;
+    }
+    lastAttempt = now;
+
+    pipe = CreateFileA(pipePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        std::cerr << "[NamedPipeClientTransport] Failed to open pipe " << pipePath << ". Error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    DWORD mode = PIPE_READMODE_MESSAGE;
+    SetNamedPipeHandleState(pipe, &mode, NULL, NULL);
+    ++generation;
+    std::cout << "[NamedPipeClientTransport] Connected to " << pipePath << std::endl;
+    return true;
+}
+
+void NamedPipeClientTransport::disconnect() {
+    if (pipe != INVALID_HANDLE_VALUE) {
+        CloseHandle(pipe);
+        pipe = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool NamedPipeClientTransport::send(const Message& msg) {
+    uint8_t packet[BusCodec::MAX_PACKET_SIZE];
+
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    std::size_t size = codec->encode(msg, packet);
+    if (size == 0 || !ensureConnected()) {
+        return false;
+    }
+
+    DWORD bytesWritten = 0;
+    if (WriteFile(pipe, packet, static_cast<DWORD>(size), &bytesWritten, NULL) && bytesWritten == size) {
+        return true;
+    }
+    std::cerr << "[NamedPipeClientTransport] Write to " << pipePath << " failed. Error: " << GetLastError() << std::endl;
+    disconnect();
+    return false;
+}
+
+bool NamedPipeClientTransport::receive(Message& msg) {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (!ensureConnected()) {
+        return false;
+    }
+
+    uint8_t packet[BusCodec::MAX_PACKET_SIZE];
+    for (;;) {
+        DWORD available = 0;
+        if (!PeekNamedPipe(pipe, NULL, 0, NULL, &available, NULL)) {
+            std::cerr << "[NamedPipeClientTransport] Peer closed " << pipePath << std::endl;
+            disconnect();
+            break;
+        }
+        if (available == 0) {
+            break;
+        }
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(pipe, packet, sizeof(packet), &bytesRead, NULL)) {
+            if (GetLastError() != ERROR_MORE_DATA) {
+                disconnect();
+                break;
+            }
+            // Oversized message; its remainder fails to decode on the next read
+            std::cerr << "[NamedPipeClientTransport] Dropped oversized message on " << pipePath << std::endl;
+            continue;
+        }
+        if (codec->decode({ packet, bytesRead }, msg)) {
+            return true;
+        }
+        std::cerr << "[NamedPipeClientTransport] Dropped malformed " << wireFormatName(codec->format()) << " message" << std::endl;
+    }
+    codec->endBatch();
+    return false;
+}
+
+bool NamedPipeClientTransport::waitReadable(int timeoutMs) {
+    // Anonymous and named pipes cannot be waited on for readability without
+    // overlapped I/O, so poll with PeekNamedPipe
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    do {
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            DWORD available = 0;
+            if (ensureConnected() && PeekNamedPipe(pipe, NULL, 0, NULL, &available, NULL) && available > 0) {
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(READ_POLL_MS));
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+#endif // _WIN32
@@ -0,0 +1,45 @@
+// named_pipe_transport.hpp
+#pragma once
+#ifdef _WIN32
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <windows.h>
+#include "bus_codec.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// Client end of a PIPE_TYPE_MESSAGE named pipe (\\.\pipe\<name>). The handle
+// stays open across sends; after a failed write it is closed and reopened
+// lazily on the next call, at most once per RECONNECT_INTERVAL. send() and
+// receive() may be called from different threads.
+class NamedPipeClientTransport : public BusTransport {
+public:
+    explicit NamedPipeClientTransport(const std::string& pipeName, std::unique_ptr<BusCodec> codec = nullptr);
+    ~NamedPipeClientTransport() override;
+
+    bool send(const Message& msg) override;
+    bool receive(Message& msg) override;
+    bool waitReadable(int timeoutMs) override;
+    uint32_t connectionGeneration() const override { return generation; }
+
+    bool connected() const { return pipe != INVALID_HANDLE_VALUE; }
+
+private:
+    static constexpr std::chrono::milliseconds RECONNECT_INTERVAL{500};
+    static constexpr int READ_POLL_MS = 5;
+
+    // Callers hold connectionMutex
+    bool ensureConnected();
+    void disconnect();
+
+    std::string pipePath;
+    std::unique_ptr<BusCodec> codec;
+    std::mutex connectionMutex;
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    uint32_t generation = 0;
+    std::chrono::steady_clock::time_point lastAttempt{};
+};
+
+#endif // _WIN32
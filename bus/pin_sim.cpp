@@ -3,10 +3,11 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
-#include <windows.h>
+#include "endpoint_cache.hpp"
+#include "symbol_table.hpp"
 
 PinSim::PinSim(const std::string& pinName, const std::string& pipeName)
-    : pinName(pinName), pipeName(pipeName), currentState(false) {}
+    : pinName(pinName), pin(symbols().intern(pinName)), pipeName(pipeName), currentState(false) {}
 
 void PinSim::simulateBouncySignal(int durationMs, int intervalMs) {
     auto startTime = std::chrono::steady_clock::now();
@@ -23,54 +24,24 @@ void PinSim::toggleState() {
 
 void PinSim::emitState() {
     std::cout << "[PinSim] Pin " << pinName << " is now " << (currentState ? "HIGH" : "LOW") << std::endl;
-    // Write to the named pipe
-    writeToPipe(pipeName, pinName, currentState);
+    if (!endpoint) {
+        endpoint = endpointCache().acquire(pipeName);
+    }
+    if (!endpoint || !endpoint->send(Message::make(pin, NO_SYMBOL, ButtonPress{ pin, currentState }))) {
+        std::cerr << "[PinSim] Failed to write " << pinName << " to pipe " << pipeName << std::endl;
+    }
 }
 
-void writeToPipe(const std::string& pipeName, const std::string& pinName, bool state) {
-    std::cout << "[PinSim] Writing to pipe " << pipeName << " for pin " << pinName << ": " << (state ? "HIGH" : "LOW") << std::endl;
-    
-    // Create the pipe path
-    std::string pipePath = "\\\\.\\pipe\\" + pipeName;
-    
-    // Open the pipe for writing
-    HANDLE hPipe = CreateFileA(
-        pipePath.c_str(),
-        GENERIC_WRITE,
-        0,
-        NULL,
-        OPEN_EXISTING,
-        0,
-        NULL
-    );
-    
-    if (hPipe == INVALID_HANDLE_VALUE) {
-        std::cerr << "[PinSim] Failed to open pipe " << pipePath << ". Error: " << GetLastError() << std::endl;
-        return;
-    }
-    
-    // Create the message
-    std::string message = pinName + ":" + (state ? "HIGH" : "LOW");
-    
-    // Write to the pipe
-    DWORD bytesWritten;
-    BOOL success = WriteFile(
-        hPipe,
-        message.c_str(),
-        static_cast<DWORD>(message.length()),
-        &bytesWritten,
-        NULL
-    );
-    
-    if (!success) {
-        std::cerr << "[PinSim] Failed to write to pipe. Error: " << GetLastError() << std::endl;
+void writeToPipe(const std::string& pipeName, SymbolId pin, bool state) {
+    std::cout << "[PinSim] Writing to pipe " << pipeName << " for pin " << symbols().name(pin) << ": " << (state ? "HIGH" : "LOW") << std::endl;
+
+    // A ButtonPress sourced from the pin itself, over a connection that stays open
+    if (!endpointCache().send(pipeName, Message::make(pin, NO_SYMBOL, ButtonPress{ pin, state }))) {
+        std::cerr << "[PinSim] Failed to write to pipe " << pipeName << std::endl;
     }
-    
-    // Close the pipe
-    CloseHandle(hPipe);
 }
 
-void emitPinState(const std::string& pinName, const std::string& pipeName, bool state) {
-    std::cout << "[PinSim] Emitting state for pin " << pinName << " on pipe " << pipeName << ": " << (state ? "HIGH" : "LOW") << std::endl;
-    writeToPipe(pipeName, pinName, state);
+void emitPinState(SymbolId pin, const std::string& pipeName, bool state) {
+    std::cout << "[PinSim] Emitting state for pin " << symbols().name(pin) << " on pipe " << pipeName << ": " << (state ? "HIGH" : "LOW") << std::endl;
+    writeToPipe(pipeName, pin, state);
 }
\ No newline at end of file
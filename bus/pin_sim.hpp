@@ -1,6 +1,9 @@
 // pin_sim.hpp
 #pragma once
+#include <memory>
 #include <string>
+#include "bus_transport.hpp"
+#include "symbol_table.hpp"
 
 class PinSim {
 public:
@@ -11,8 +14,10 @@ public:
 
 private:
     std::string pinName;
+    SymbolId pin;                           // pinName, interned once
     std::string pipeName;
     bool currentState;
+    std::shared_ptr<BusTransport> endpoint; // From endpointCache(), opened on first emit
 
     // Toggle the pin state and emit the new state
     void toggleState();
@@ -21,8 +26,9 @@ private:
     void emitState();
 };
 
-// Helper function to write to named pipe
-void writeToPipe(const std::string& pipeName, const std::string& pinName, bool state);
+// Send the pin's state through the cached connection to the named pipe.
+// Takes the interned pin so a caller toggling it often interns it once.
+void writeToPipe(const std::string& pipeName, SymbolId pin, bool state);
 
 // External function to emit pin state
-void emitPinState(const std::string& pinName, const std::string& pipeName, bool state);
+void emitPinState(SymbolId pin, const std::string& pipeName, bool state);
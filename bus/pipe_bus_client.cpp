@@ -1,35 +1,249 @@
 #include <iostream>
 #include <stdexcept>
+#ifdef _WIN32
 #include <windows.h> // For named pipe operations
+#endif
+#ifdef __linux__
+#include <csignal>
+#include <pthread.h>
+#endif
 #include "pipe_bus_client.hpp" // Corrected include path
 #include "message_types.hpp" // Corrected include path
+#include "endpoint_cache.hpp"
+#include "wire_format.hpp"
 
-std::mutex PipeBusClient::busMutex;
+namespace {
+
+    // Start a worker with every signal blocked, so SIGINT and friends go to
+    // a thread that handles them rather than killing the process mid-write
+    template <typename F>
+    std::thread startWorker(F&& body) {
+#ifdef __linux__
+        sigset_t all;
+        sigset_t previous;
+        sigfillset(&all);
+        pthread_sigmask(SIG_SETMASK, &all, &previous);
+        std::thread worker(std::forward<F>(body));
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        return worker;
+#else
+        return std::thread(std::forward<F>(body));
+#endif
+    }
+
+} // namespace
 
 PipeBusClient::PipeBusClient(const std::string& client_id) : client_id_(client_id) {
     // Initialization logic for the named pipe client
+    writer_ = startWorker([this] { write_loop(); });
     std::cout << "[PipeBusClient] Initialized client with ID: " << client_id_ << std::endl;
 }
 
 PipeBusClient::~PipeBusClient() {
+    stop_receiving();
+    close();
     // Cleanup logic for the named pipe client
     std::cout << "[PipeBusClient] Destroyed client with ID: " << client_id_ << std::endl;
 }
 
+void PipeBusClient::attach(std::shared_ptr<BusTransport> transport) {
+    // Attach before the first send; the writer thread reads transport_ unsynchronized
+    transport_ = std::move(transport);
+    std::cout << "[PipeBusClient] Transport attached for client " << client_id_ << std::endl;
+}
+
+void PipeBusClient::connect(const std::string& pipeName, WireFormat format) {
+    attach(endpointCache().acquire(pipeName, format));
+}
+
 void PipeBusClient::send(const Message& message) {
-    std::lock_guard<std::mutex> lock(busMutex);
+#ifdef __linux__
+    if (loop_) {
+        loop_->send(*transport_, message);
+        return;
+    }
+#endif
+    // Announce the send before checking writing_: close() waits for every
+    // announced send to finish before the writer's final drain, so nothing
+    // is pushed after it and left for flush() to wait on forever
+    senders_.fetch_add(1);
+    if (!writing_.load() || !sendQueue_.tryPush(message)) {
+        senders_.fetch_sub(1);
+        // Reported by the writer thread; the caller never does I/O
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    enqueued_.fetch_add(1, std::memory_order_release);
+    senders_.fetch_sub(1);
+
+    // Pairs with write_loop(): either the writer sees this bump before it
+    // sleeps, or we see it idle and wake it
+    signal_.fetch_add(1);
+    if (writerIdle_.load()) {
+        signal_.notify_one();
+    }
+}
 
-    // Serialize the message
-    std::string serializedMessage = message.from + "," + message.to + "," + (message.isButtonPress() ? "ButtonPress" : "Unknown");
+void PipeBusClient::flush() {
+#ifdef __linux__
+    if (loop_) {
+        loop_->flush();
+        return;
+    }
+#endif
+    uint64_t target = enqueued_.load(std::memory_order_acquire);
+    uint64_t done = written_.load(std::memory_order_acquire);
+    while (done < target) {
+        written_.wait(done, std::memory_order_acquire);
+        done = written_.load(std::memory_order_acquire);
+    }
+}
+
+void PipeBusClient::close() {
+    if (!writing_.exchange(false)) {
+        return;
+    }
+    // Sends that saw writing_ still set finish their push first; only then
+    // may the writer make its final drain and exit
+    while (senders_.load() != 0) {
+        std::this_thread::yield();
+    }
+    drained_.store(true);
+    signal_.fetch_add(1);
+    signal_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void PipeBusClient::write_loop() {
+    Message batch[WRITE_BATCH];
+    uint64_t reportedDrops = 0;
 
-    // Simulate writing to the named pipe
-    std::cout << "[PipeBusClient] Writing serialized message: " << serializedMessage << std::endl;
+    auto drain = [this, &batch] {
+        std::size_t count = 0;
+        while (count < WRITE_BATCH && sendQueue_.tryPop(batch[count])) {
+            ++count;
+        }
+        return count;
+    };
+
+    for (;;) {
+        std::size_t count = drain();
+        if (count == 0) {
+            // Announce the sleep before the last check so a concurrent send
+            // either lands in that check or sees us idle and notifies
+            writerIdle_.store(true);
+            uint32_t seen = signal_.load();
+            count = drain();
+            if (count == 0) {
+                if (drained_.load()) {
+                    writerIdle_.store(false);
+                    break;
+                }
+                signal_.wait(seen);
+                writerIdle_.store(false);
+                continue;
+            }
+            writerIdle_.store(false);
+        }
+
+        write_batch(batch, count);
+        written_.fetch_add(count, std::memory_order_release);
+        written_.notify_all();
+
+        uint64_t drops = dropped_.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            std::cerr << "[PipeBusClient] Send queue full, dropped " << drops - reportedDrops
+                      << " messages for client " << client_id_ << std::endl;
+            reportedDrops = drops;
+        }
+    }
+}
+
+void PipeBusClient::write_batch(const Message* messages, std::size_t count) {
+    if (transport_) {
+        std::size_t sent = transport_->sendBatch({ messages, count });
+        if (sent < count) {
+            std::cerr << "[PipeBusClient] Transport full, dropped " << count - sent
+                      << " messages from client " << client_id_ << std::endl;
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        // Serialize the message into a binary frame
+        uint8_t frame[MAX_FRAME_SIZE];
+        std::size_t size = encodeFrame(messages[i], frame);
+
+        // Simulate writing to the named pipe
+        std::cout << "[PipeBusClient] Writing " << size << "-byte frame: " << symbols().name(messages[i].from)
+                  << " -> " << symbols().name(messages[i].to) << std::endl;
+    }
 }
 
 void PipeBusClient::on_receive(std::function<void(const Message&)> handler) {
+    // Set the handler before start_receiving(); the receive thread reads it unsynchronized
     handler_ = handler;
     std::cout << "[PipeBusClient] Receive handler set for client " << client_id_ << std::endl;
-    // Simulate listening for messages
+}
+
+void PipeBusClient::on_receive_view(std::function<void(const MessageView&)> handler) {
+    view_handler_ = std::move(handler);
+    std::cout << "[PipeBusClient] View handler set for client " << client_id_ << std::endl;
+}
+
+void PipeBusClient::start_receiving() {
+    if (!transport_ || receiving_.exchange(true)) {
+        return;
+    }
+    receiver_ = startWorker([this] { receive_loop(); });
+    std::cout << "[PipeBusClient] Receive thread started for client " << client_id_ << std::endl;
+}
+
+void PipeBusClient::stop_receiving() {
+    if (!receiving_.exchange(false)) {
+        return;
+    }
+    if (receiver_.joinable()) {
+        receiver_.join();
+    }
+}
+
+#ifdef __linux__
+bool PipeBusClient::attach_to(BusLoop& loop) {
+    if (!transport_) {
+        return false;
+    }
+    loop_ = &loop;
+    bool pollable = loop.addViewEndpoint(*transport_, [this](const MessageView& view) { deliver(view); });
+    std::cout << "[PipeBusClient] Client " << client_id_ << " attached to event loop"
+              << (pollable ? "" : " (waiting for connection)") << std::endl;
+    return pollable;
+}
+#endif
+
+void PipeBusClient::receive_loop() {
+    MessageView view;
+    while (receiving_.load(std::memory_order_relaxed)) {
+        if (!transport_->waitReadable(RECEIVE_POLL_MS)) {
+            continue;
+        }
+        while (transport_->receiveView(view)) {
+            deliver(view);
+        }
+    }
+}
+
+void PipeBusClient::deliver(const MessageView& view) {
+    if (view_handler_) {
+        view_handler_(view);
+        return;
+    }
+    Message message;
+    if (handler_ && view.materialize(message)) {
+        handler_(message);
+    }
 }
 
 const std::string& PipeBusClient::id() const {
@@ -1,20 +1,101 @@
 #pragma once
 #include <string>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 #include <functional>
+#include <memory>
 #include "message_types.hpp" // Updated to use the new Message structure
+#include "bus_codec.hpp"
+#include "bus_transport.hpp"
+#include "message_view.hpp"
+#include "mpsc_ring.hpp"
+#ifdef __linux__
+#include "bus_loop.hpp"
+#endif
 
 class PipeBusClient {
 public:
+    static constexpr std::size_t SEND_QUEUE_CAPACITY = 1024;
+    static constexpr std::size_t WRITE_BATCH = 64;      // Messages per transport call
+
     PipeBusClient(const std::string& client_id);
     ~PipeBusClient();
 
+    // Route all I/O through transport (e.g. ShmTransport on Linux)
+    void attach(std::shared_ptr<BusTransport> transport);
+
+    // Attach the process-wide cached connection to pipeName (endpoint_cache.hpp)
+    void connect(const std::string& pipeName, WireFormat format = WireFormat::BINARY);
+
+    // Never blocks: the message is queued for the writer thread, which
+    // batches it with others and does the transport I/O. Safe from any
+    // thread. If the queue is full the message is dropped and counted.
     void send(const Message& message);
     void on_receive(std::function<void(const Message&)> handler);
+
+    // Receive zero-copy views instead of decoded copies (message_view.hpp).
+    // A view is valid only during the call; use materialize() to keep one.
+    // Takes precedence over on_receive(). Set before receiving starts.
+    void on_receive_view(std::function<void(const MessageView&)> handler);
+
+    // Block until every message sent before the call has been written (or
+    // dropped by the transport)
+    void flush();
+
+    // Flush, then stop the writer thread; later sends are dropped. The
+    // destructor calls it. The client's threads run with all signals
+    // blocked.
+    void close();
+
+    // Start/stop a thread that waits on the transport and invokes the
+    // receive handler for every message. The destructor stops it.
+    void start_receiving();
+    void stop_receiving();
+
+#ifdef __linux__
+    // Alternative to start_receiving(): let a shared BusLoop drain the
+    // transport instead of a dedicated thread, and send through it so sends
+    // are batched with the loop's other I/O. send() must then be called from
+    // the loop thread and bypasses the writer thread. Returns false if the
+    // transport is not pollable yet.
+    bool attach_to(BusLoop& loop);
+#endif
+
     const std::string& id() const;
 
+    // Messages rejected because the send queue was full or the client closed
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
 private:
+    static constexpr int RECEIVE_POLL_MS = 100;
+
+    void receive_loop();
+    void deliver(const MessageView& view);
+    void write_loop();
+    void write_batch(const Message* messages, std::size_t count);
+
     std::string client_id_;
     std::function<void(const Message&)> handler_;
-    static std::mutex busMutex; // Shared mutex for synchronizing access to the bus
+    std::function<void(const MessageView&)> view_handler_;
+    std::shared_ptr<BusTransport> transport_;
+#ifdef __linux__
+    BusLoop* loop_ = nullptr;
+#endif
+    std::thread receiver_;
+    std::atomic<bool> receiving_{false};
+
+    // Async send path. signal_ is bumped on every enqueue and wakes the
+    // writer only while it sleeps; written_ counts messages the writer has
+    // finished with, so flush() can wait for a target count.
+    MpscRing<Message> sendQueue_{SEND_QUEUE_CAPACITY};
+    std::thread writer_;
+    std::atomic<bool> writing_{true};
+    std::atomic<bool> drained_{false};     // Set by close() once no send can still push
+    std::atomic<bool> writerIdle_{false};
+    std::atomic<uint32_t> signal_{0};
+    std::atomic<uint32_t> senders_{0};     // send() calls between their writing_ check and push
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
 };
@@ -0,0 +1,140 @@
+// protobuf_codec.cpp
+#include "protobuf_codec.hpp"
+#ifdef FIDGET_WITH_PROTOBUF
+#include <cstring>
+#include <string>
+#include "message_registry.hpp"
+#include "symbol_table.hpp"
+#include "wire_format.hpp"
+
+namespace {
+
+    constexpr const char* ACTION_PRESS = "press";
+    constexpr const char* ACTION_RELEASE = "release";
+    constexpr const char* ACTION_ANALOG = "analog";
+    constexpr const char* STATE_PHASE = "phase";
+
+    constexpr std::size_t MAX_HEADER_SIZE = 1 + 3;  // Tag plus a 16-bit varint
+
+    // Never interns: the table is bounded and a peer must not be able to
+    // fill it. Names missing from the config come back as NO_SYMBOL.
+    SymbolId symbolFor(const std::string& name) {
+        return symbols().find(name);
+    }
+
+} // namespace
+
+ProtobufCodec::ProtobufCodec()
+    : encodeBlock(std::make_unique<char[]>(ARENA_BLOCK_SIZE)),
+      batchBlock(std::make_unique<char[]>(ARENA_BLOCK_SIZE)),
+      encodeArena(encodeBlock.get(), ARENA_BLOCK_SIZE),
+      batchArena(batchBlock.get(), ARENA_BLOCK_SIZE),
+      outEvent(google::protobuf::Arena::Create<reactor::UIEvent>(&encodeArena)),
+      outState(google::protobuf::Arena::Create<reactor::SimStateUpdate>(&encodeArena)) {}
+
+std::size_t ProtobufCodec::serialize(PacketTag tag, SymbolId to, const google::protobuf::MessageLite& proto,
+                                     std::span<uint8_t> out) {
+    uint8_t header[MAX_HEADER_SIZE];
+    header[0] = tag;
+    std::size_t headerSize = static_cast<std::size_t>(detail::putVarint(header + 1, to) - header);
+
+    std::size_t size = proto.ByteSizeLong();
+    if (headerSize + size > out.size()) {
+        return 0;
+    }
+    std::memcpy(out.data(), header, headerSize);
+    proto.SerializeWithCachedSizesToArray(out.data() + headerSize);
+    return headerSize + size;
+}
+
+std::size_t ProtobufCodec::encode(const Message& msg, std::span<uint8_t> out) {
+    std::size_t size = 0;
+    dispatchMessage(msg,
+        [&](const ButtonPress& press) {
+            outEvent->set_component(symbols().name(press.button_id));
+            outEvent->set_action(press.pressed ? ACTION_PRESS : ACTION_RELEASE);
+            outEvent->set_value(press.pressed ? 1 : 0);
+            size = serialize(TAG_UI_EVENT, msg.to, *outEvent, out);
+        },
+        [&](const StateTransition& transition) {
+            outState->set_component(symbols().name(msg.from));
+            outState->set_state(STATE_PHASE);
+            outState->set_numeric_value(transition.phase);
+            size = serialize(TAG_SIM_STATE_UPDATE, msg.to, *outState, out);
+        },
+        [&](const AnalogSample& sample) {
+            outEvent->set_component(symbols().name(sample.channel));
+            outEvent->set_action(ACTION_ANALOG);
+            outEvent->set_value(sample.value);
+            size = serialize(TAG_UI_EVENT, msg.to, *outEvent, out);
+        });
+    return size;
+}
+
+bool ProtobufCodec::decode(std::span<const uint8_t> packet, Message& msg) {
+    const uint8_t* body = packet.data() + 1;
+    const uint8_t* end = packet.data() + packet.size();
+    SymbolId to = NO_SYMBOL;
+    if (packet.empty() || !detail::getSymbol(body, end, to)) {
+        return false;
+    }
+    int bodySize = static_cast<int>(end - body);
+
+    switch (packet[0]) {
+        case TAG_UI_EVENT: {
+            if (!inEvent) {
+                inEvent = google::protobuf::Arena::Create<reactor::UIEvent>(&batchArena);
+            }
+            if (!inEvent->ParseFromArray(body, bodySize)) {
+                return false;
+            }
+            SymbolId component = symbolFor(inEvent->component());
+            if (component == NO_SYMBOL) {
+                return false;
+            }
+            if (inEvent->action() == ACTION_ANALOG) {
+                msg = Message::make(component, to, AnalogSample{ component, inEvent->value() });
+            } else {
+                msg = Message::make(component, to, ButtonPress{ component, inEvent->value() != 0 });
+            }
+            return true;
+        }
+        case TAG_SIM_STATE_UPDATE: {
+            if (!inState) {
+                inState = google::protobuf::Arena::Create<reactor::SimStateUpdate>(&batchArena);
+            }
+            if (!inState->ParseFromArray(body, bodySize)) {
+                return false;
+            }
+            SymbolId component = symbolFor(inState->component());
+            if (component == NO_SYMBOL) {
+                return false;
+            }
+            StateTransition transition{ static_cast<uint8_t>(inState->numeric_value()) };
+            msg = Message::make(component, to, transition);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void ProtobufCodec::endBatch() {
+    // Resetting every batch would recreate the parsed objects, and each of
+    // their strings is a fresh heap allocation the arena only owns. Keep
+    // them while the batch fits the first block; parsing into them reuses
+    // the strings.
+    if (batchArena.SpaceAllocated() <= ARENA_BLOCK_SIZE) {
+        return;
+    }
+    // Objects on the arena are gone after Reset; recreate them next batch
+    batchArena.Reset();
+    inEvent = nullptr;
+    inState = nullptr;
+}
+
+std::unique_ptr<BusCodec> makeProtobufCodec() {
+    return std::make_unique<ProtobufCodec>();
+}
+
+#endif // FIDGET_WITH_PROTOBUF
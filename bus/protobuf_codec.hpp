@@ -0,0 +1,62 @@
+// protobuf_codec.hpp
+#pragma once
+#ifdef FIDGET_WITH_PROTOBUF
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <google/protobuf/arena.h>
+#include "generated/reactor.pb.h"
+#include "bus_codec.hpp"
+#include "message_types.hpp"
+
+// BusCodec over the proto/reactor.proto schema. ButtonPress and AnalogSample
+// travel as UIEvent, StateTransition as SimStateUpdate. In front of the
+// serialized message go a one-byte tag saying which, then the destination's
+// SymbolId as a varint (as in wire_format.hpp), so routing by `to` works
+// as with binary frames. The schema names components rather than senders,
+// so `seq` is not carried and decoded messages come from the component they
+// name. A packet naming a component missing from the symbol table is
+// rejected; peer input is never interned.
+//
+// Outbound messages are two arena-allocated objects reused for every send,
+// so their strings keep their capacity across ticks. Inbound messages are
+// parsed into objects on a batch arena and reused the same way; endBatch()
+// resets the arena back to its preallocated first block only if a batch
+// outgrew it. In steady state neither direction touches the heap
+// (bench/codec_bench.cpp counts).
+class ProtobufCodec : public BusCodec {
+public:
+    static constexpr std::size_t ARENA_BLOCK_SIZE = 4096;
+
+    ProtobufCodec();
+
+    std::size_t encode(const Message& msg, std::span<uint8_t> out) override;
+    bool decode(std::span<const uint8_t> packet, Message& msg) override;
+    void endBatch() override;
+
+    WireFormat format() const override { return WireFormat::PROTOBUF; }
+
+    // Bytes currently held by the inbound batch arena
+    uint64_t batchArenaBytes() const { return batchArena.SpaceAllocated(); }
+
+private:
+    enum PacketTag : uint8_t {
+        TAG_UI_EVENT = 1,
+        TAG_SIM_STATE_UPDATE = 2
+    };
+
+    std::size_t serialize(PacketTag tag, SymbolId to, const google::protobuf::MessageLite& proto, std::span<uint8_t> out);
+
+    std::unique_ptr<char[]> encodeBlock;
+    std::unique_ptr<char[]> batchBlock;
+    google::protobuf::Arena encodeArena;
+    google::protobuf::Arena batchArena;
+
+    reactor::UIEvent* outEvent;
+    reactor::SimStateUpdate* outState;
+    reactor::UIEvent* inEvent = nullptr;
+    reactor::SimStateUpdate* inState = nullptr;
+};
+
+#endif // FIDGET_WITH_PROTOBUF
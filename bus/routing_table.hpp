@@ -0,0 +1,94 @@
+// routing_table.hpp
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "message_types.hpp"
+#include "symbol_table.hpp"
+
+// Dense handle for a message consumer registered with the routing table
+using SubscriberId = uint16_t;
+
+// Maps (destination, payload type) to the subscribers that want it.
+// Subscriptions are collected at startup, then build() flattens them into a
+// direct-indexed offset table so each lookup is two array reads.
+// Signal traffic (ButtonPress from a PHC) is addressed to its wiring alias,
+// e.g. to = SCRAM, so listen_for entries subscribe to those aliases.
+class RoutingTable {
+public:
+    SubscriberId addSubscriber(SymbolId name) {
+        if (built) {
+            throw std::logic_error("RoutingTable: cannot add subscribers after build()");
+        }
+        subscriberNames.push_back(name);
+        return static_cast<SubscriberId>(subscriberNames.size() - 1);
+    }
+
+    void subscribe(SubscriberId subscriber, SymbolId destination, MessageType type) {
+        if (built) {
+            throw std::logic_error("RoutingTable: cannot subscribe after build()");
+        }
+        pending.push_back({ slotFor(destination, type), subscriber });
+    }
+
+    // Freeze the subscriptions into offsets/targets (CSR layout)
+    void build() {
+        std::size_t symbolCount = symbols().size();
+        for (const Entry& e : pending) {
+            symbolCount = std::max(symbolCount, e.slot / MESSAGE_TYPE_COUNT + 1);
+        }
+
+        std::stable_sort(pending.begin(), pending.end(),
+            [](const Entry& a, const Entry& b) { return a.slot < b.slot; });
+        pending.erase(std::unique(pending.begin(), pending.end(),
+            [](const Entry& a, const Entry& b) { return a.slot == b.slot && a.subscriber == b.subscriber; }),
+            pending.end());
+
+        offsets.assign(symbolCount * MESSAGE_TYPE_COUNT + 1, 0);
+        for (const Entry& e : pending) {
+            ++offsets[e.slot + 1];
+        }
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        targets.clear();
+        for (const Entry& e : pending) {
+            targets.push_back(e.subscriber);
+        }
+        pending.clear();
+        pending.shrink_to_fit();
+        built = true;
+    }
+
+    std::span<const SubscriberId> subscribersFor(SymbolId destination, MessageType type) const {
+        std::size_t slot = slotFor(destination, type);
+        if (slot + 1 >= offsets.size()) {
+            return {};
+        }
+        return { targets.data() + offsets[slot], offsets[slot + 1] - offsets[slot] };
+    }
+
+    std::size_t subscriberCount() const { return subscriberNames.size(); }
+    SymbolId subscriberName(SubscriberId id) const { return subscriberNames[id]; }
+    bool isBuilt() const { return built; }
+
+private:
+    struct Entry {
+        std::size_t slot;
+        SubscriberId subscriber;
+    };
+
+    static std::size_t slotFor(SymbolId destination, MessageType type) {
+        return static_cast<std::size_t>(destination) * MESSAGE_TYPE_COUNT + static_cast<std::size_t>(type);
+    }
+
+    std::vector<SymbolId> subscriberNames;
+    std::vector<Entry> pending;
+    std::vector<uint32_t> offsets;
+    std::vector<SubscriberId> targets;
+    bool built = false;
+};
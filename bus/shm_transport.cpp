@@ -0,0 +1,306 @@
+// shm_transport.cpp
+#ifdef __linux__
+#include "shm_transport.hpp"
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr uint32_t SHM_MAGIC = 0x46524D42; // "FRMB"
+    constexpr uint32_t SHM_VERSION = 2;
+    constexpr int SPIN_ITERATIONS = 2000;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs address-free atomics");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory ring needs address-free atomics");
+
+    long futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs) {
+        timespec timeout{ timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+                       timeoutMs >= 0 ? &timeout : nullptr, nullptr, 0);
+    }
+
+    long futexWake(std::atomic<uint32_t>* word) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+
+    std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+} // namespace
+
+// Lives at the start of the mapping; Message slots follow it
+struct ShmRing::Header {
+    std::atomic<uint32_t> ready;     // Set to SHM_MAGIC once initialized
+    uint32_t version;
+    uint32_t capacity;               // Power of two
+    uint32_t slotSize;
+    std::atomic<int32_t> ownerPid;   // Process that created the region
+
+    alignas(64) std::atomic<uint64_t> head;        // Advanced by the producer
+    alignas(64) std::atomic<uint64_t> tail;        // Advanced by the consumer
+    alignas(64) std::atomic<uint32_t> wakeSeq;     // Futex word
+    std::atomic<uint32_t> consumerWaiting;
+};
+
+ShmRing::ShmRing(const std::string& name, std::size_t capacity) : regionName(name) {
+    capacity = roundUpPow2(capacity);
+
+    // A region whose creator has exited is left over from a crash. Its
+    // head and tail belong to the old session, so it is replaced, once.
+    for (int attempt = 0; attempt < 2 && !header; ++attempt) {
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            create(fd, capacity);
+            break;
+        }
+        if (errno == EEXIST) {
+            fd = shm_open(name.c_str(), O_RDWR, 0600);
+        }
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                continue;   // Unlinked between the two opens
+            }
+            throw std::runtime_error("ShmRing: shm_open failed for " + name + ": " + std::strerror(errno));
+        }
+        attach(fd);
+    }
+    if (!header) {
+        throw std::runtime_error("ShmRing: could not replace stale region " + name);
+    }
+
+    std::cout << "[ShmRing] " << (owner ? "Created" : "Attached to") << " region " << name
+              << " (" << header->capacity << " slots)" << std::endl;
+}
+
+void ShmRing::create(int fd, std::size_t capacity) {
+    owner = true;
+    mappedBytes = sizeof(Header) + capacity * sizeof(Message);
+    if (ftruncate(fd, static_cast<off_t>(mappedBytes)) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(regionName.c_str());
+        throw std::runtime_error("ShmRing: ftruncate failed for " + regionName + ": " + std::strerror(err));
+    }
+    void* mapping = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        int err = errno;
+        shm_unlink(regionName.c_str());
+        throw std::runtime_error("ShmRing: mmap failed for " + regionName + ": " + std::strerror(err));
+    }
+
+    // The region is zero-filled by ftruncate, so the atomics start at 0
+    header = static_cast<Header*>(mapping);
+    slots = reinterpret_cast<Message*>(static_cast<char*>(mapping) + sizeof(Header));
+    header->version = SHM_VERSION;
+    header->capacity = static_cast<uint32_t>(capacity);
+    header->slotSize = sizeof(Message);
+    header->ownerPid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+    header->ready.store(SHM_MAGIC, std::memory_order_release);
+}
+
+void ShmRing::attach(int fd) {
+    // The creator sizes the region right after creating it
+    struct stat st{};
+    for (int attempt = 0; attempt < 1000 && fstat(fd, &st) == 0 && st.st_size == 0; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("ShmRing: region " + regionName + " is too small");
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("ShmRing: mmap failed for " + regionName + ": " + std::strerror(errno));
+    }
+    Header* existing = static_cast<Header*>(mapping);
+
+    for (int attempt = 0; attempt < 1000 && existing->ready.load(std::memory_order_acquire) != SHM_MAGIC; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    pid_t creator = existing->ownerPid.load(std::memory_order_relaxed);
+    if (creator == 0 || (kill(creator, 0) != 0 && errno == ESRCH)) {
+        munmap(mapping, size);
+        removeIfUnchanged(st);
+        std::cerr << "[ShmRing] Replacing stale region " << regionName << " left by process " << creator << std::endl;
+        return;
+    }
+
+    // Trust nothing in the header that sizes an access into the mapping
+    uint32_t capacity = existing->capacity;
+    if (existing->ready.load(std::memory_order_acquire) != SHM_MAGIC ||
+        existing->version != SHM_VERSION || existing->slotSize != sizeof(Message) ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        size < sizeof(Header) + std::size_t{capacity} * sizeof(Message)) {
+        munmap(mapping, size);
+        throw std::runtime_error("ShmRing: incompatible or uninitialized region " + regionName);
+    }
+
+    header = existing;
+    slots = reinterpret_cast<Message*>(static_cast<char*>(mapping) + sizeof(Header));
+    mappedBytes = size;
+}
+
+void ShmRing::removeIfUnchanged(const struct stat& seen) {
+    // Another process may already have replaced it; only unlink the region we looked at
+    int fd = shm_open(regionName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+    struct stat current{};
+    if (fstat(fd, &current) == 0 && current.st_ino == seen.st_ino && current.st_dev == seen.st_dev) {
+        shm_unlink(regionName.c_str());
+    }
+    close(fd);
+}
+
+ShmRing::~ShmRing() {
+    if (header) {
+        munmap(header, mappedBytes);
+    }
+    if (owner) {
+        shm_unlink(regionName.c_str());
+    }
+}
+
+bool ShmRing::tryPush(const Message& msg) {
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    uint64_t tail = header->tail.load(std::memory_order_acquire);
+    if (head - tail >= header->capacity) {
+        return false;
+    }
+    slots[head & (header->capacity - 1)] = msg;
+    header->head.store(head + 1, std::memory_order_release);
+
+    // Pairs with the fence in waitReadable: either we see the consumer's
+    // waiting flag, or it sees our new head before going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header->consumerWaiting.load(std::memory_order_relaxed)) {
+        header->wakeSeq.fetch_add(1, std::memory_order_release);
+        futexWake(&header->wakeSeq);
+    }
+    return true;
+}
+
+bool ShmRing::tryPop(Message& msg) {
+    uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    if (tail == header->head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    msg = slots[tail & (header->capacity - 1)];
+    header->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool ShmRing::waitReadable(int timeoutMs) {
+    auto readable = [this] {
+        return header->tail.load(std::memory_order_relaxed) != header->head.load(std::memory_order_acquire);
+    };
+
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        if (readable()) {
+            return true;
+        }
+    }
+
+    uint32_t seq = header->wakeSeq.load(std::memory_order_acquire);
+    header->consumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!readable()) {
+        futexWait(&header->wakeSeq, seq, timeoutMs);
+    }
+    header->consumerWaiting.store(0, std::memory_order_relaxed);
+    return readable();
+}
+
+void ShmRing::interruptWait() {
+    header->wakeSeq.fetch_add(1, std::memory_order_release);
+    futexWake(&header->wakeSeq);
+}
+
+ShmTransport::ShmTransport(const std::string& localName, const std::string& peerName, std::size_t capacity,
+                           bool pollable)
+    : tx(regionName(localName, peerName), capacity),
+      rx(regionName(peerName, localName), capacity) {
+    if (!pollable) {
+        return;
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        throw std::runtime_error("ShmTransport: eventfd failed: " + std::string(std::strerror(errno)));
+    }
+    waiter = std::thread([this] { waitLoop(); });
+}
+
+ShmTransport::~ShmTransport() {
+    if (waiter.joinable()) {
+        stopping.store(true);
+        signalled.store(false);
+        signalled.notify_one();
+        rx.interruptWait();
+        waiter.join();
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+    }
+}
+
+bool ShmTransport::receive(Message& msg) {
+    if (rx.tryPop(msg)) {
+        return true;
+    }
+    if (wakeFd < 0) {
+        return false;
+    }
+    // Drained, the way a socket read ends in EAGAIN. Clear the eventfd
+    // whether or not the waiter has flagged it yet, so a level-triggered
+    // loop never spins on a stale signal, then let the waiter recheck the
+    // ring; a message pushed meanwhile signals it again.
+    uint64_t count;
+    while (read(wakeFd, &count, sizeof(count)) < 0 && errno == EINTR) {
+    }
+    if (signalled.exchange(false, std::memory_order_acq_rel)) {
+        signalled.notify_one();
+    }
+    return false;
+}
+
+void ShmTransport::waitLoop() {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (!rx.waitReadable(WAITER_TIMEOUT_MS)) {
+            continue;
+        }
+        signalled.store(true, std::memory_order_release);
+        uint64_t one = 1;
+        while (write(wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+        // The reader owns the ring until it finds it empty
+        signalled.wait(true, std::memory_order_acquire);
+    }
+}
+
+std::string ShmTransport::regionName(const std::string& producer, const std::string& consumer) {
+    return "/fidget_" + producer + "_to_" + consumer;
+}
+
+#endif // __linux__
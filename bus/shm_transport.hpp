@@ -0,0 +1,94 @@
+// shm_transport.hpp
+#pragma once
+#ifdef __linux__
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// One direction of a shared-memory link: a lock-free SPSC ring of fixed-size
+// Messages in an shm_open/mmap region. The consumer sleeps on a futex only
+// when the ring is empty and the producer wakes it only if it is asleep, so a
+// busy link never makes a syscall.
+class ShmRing {
+public:
+    // Creates the region if it does not exist, otherwise attaches to it. A
+    // region whose creator has exited is unlinked and created afresh; a peer
+    // still mapping it must reconnect. Throws std::runtime_error if the
+    // region cannot be created or does not hold a ring of Messages.
+    ShmRing(const std::string& name, std::size_t capacity);
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    bool tryPush(const Message& msg);
+    bool tryPop(Message& msg);
+
+    // Consumer side. Spin briefly, then sleep until data arrives or timeout.
+    bool waitReadable(int timeoutMs);
+
+    // Wake a consumer sleeping in waitReadable() early
+    void interruptWait();
+
+    const std::string& name() const { return regionName; }
+
+private:
+    struct Header;
+
+    void create(int fd, std::size_t capacity);
+    void attach(int fd);    // Leaves header null if the region was stale
+    void removeIfUnchanged(const struct stat& seen);
+
+    std::string regionName;
+    Header* header = nullptr;
+    Message* slots = nullptr;
+    std::size_t mappedBytes = 0;
+    bool owner = false;
+};
+
+// Duplex transport between two local processes over a pair of ShmRings named
+// after the (producer, consumer) pair, e.g. /fidget_phc_a_to_main_controller.
+//
+// A ring has no descriptor of its own. A pollable transport starts a thread
+// that sleeps on the receive ring's futex and makes pollFd(), an eventfd,
+// readable when messages arrive, so an event loop can multiplex the link
+// like a socket. The loop must then be the only reader: the eventfd is
+// cleared, and the thread goes back to sleep, when receive() finds the ring
+// empty.
+class ShmTransport : public BusTransport {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    // Throws std::runtime_error if a ring cannot be mapped or, when
+    // pollable, the eventfd cannot be created
+    ShmTransport(const std::string& localName, const std::string& peerName,
+                 std::size_t capacity = DEFAULT_CAPACITY, bool pollable = false);
+    ~ShmTransport() override;
+
+    bool send(const Message& msg) override { return tx.tryPush(msg); }
+    bool receive(Message& msg) override;
+    bool waitReadable(int timeoutMs) override { return rx.waitReadable(timeoutMs); }
+    int pollFd() const override { return wakeFd; }
+
+    static std::string regionName(const std::string& producer, const std::string& consumer);
+
+private:
+    static constexpr int WAITER_TIMEOUT_MS = 100;
+
+    void waitLoop();
+
+    ShmRing tx;
+    ShmRing rx;
+    int wakeFd = -1;
+    std::atomic<bool> signalled{false};     // Set by the waiter, which then sleeps until a reader clears it
+    std::atomic<bool> stopping{false};
+    std::thread waiter;
+};
+
+#endif // __linux__
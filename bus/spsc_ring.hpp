@@ -0,0 +1,80 @@
+// spsc_ring.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Size used to keep the producer and consumer indices on separate cache lines
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// Fixed-capacity, lock-free single-producer/single-consumer ring.
+// Storage is allocated once in the constructor; push/pop never allocate.
+// Exactly one thread may call tryPush and exactly one thread may call tryPop.
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit SpscRing(std::size_t capacity)
+        : mask(roundUpPow2(capacity) - 1),
+          slots(std::make_unique<T[]>(mask + 1)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. Returns false if the ring is full.
+    bool tryPush(const T& item) {
+        const std::size_t h = head.value.load(std::memory_order_relaxed);
+        if (h - head.cachedOther >= capacity()) {
+            head.cachedOther = tail.value.load(std::memory_order_acquire);
+            if (h - head.cachedOther >= capacity()) {
+                return false;
+            }
+        }
+        slots[h & mask] = item;
+        head.value.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool tryPop(T& out) {
+        const std::size_t t = tail.value.load(std::memory_order_relaxed);
+        if (t == tail.cachedOther) {
+            tail.cachedOther = head.value.load(std::memory_order_acquire);
+            if (t == tail.cachedOther) {
+                return false;
+            }
+        }
+        out = std::move(slots[t & mask]);
+        tail.value.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    std::size_t size() const {
+        const std::size_t t = tail.value.load(std::memory_order_acquire);
+        return head.value.load(std::memory_order_acquire) - t;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    // Each side's index shares a cache line with its private copy of the
+    // other side's index, so the fast path touches only local lines.
+    struct alignas(kCacheLineSize) Cursor {
+        std::atomic<std::size_t> value{0};
+        std::size_t cachedOther = 0;
+    };
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    Cursor head; // advanced by the producer
+    Cursor tail; // advanced by the consumer
+};
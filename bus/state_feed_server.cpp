@@ -0,0 +1,168 @@
+// state_feed_server.cpp
+#ifdef __linux__
+#include "state_feed_server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    // Same abstract namespace as uds_transport.cpp
+    socklen_t makeAddress(const std::string& endpointName, sockaddr_un& addr) {
+        std::string path = "fidget_reactor/" + endpointName;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::size_t length = std::min(path.size(), sizeof(addr.sun_path) - 1);
+        std::memcpy(addr.sun_path + 1, path.data(), length);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + length);
+    }
+
+} // namespace
+
+StateFeedServer::StateFeedServer(BusLoop& loop, StatePublisher& publisher, const std::string& endpointName)
+    : loop(loop), publisher(publisher), endpointName(endpointName) {
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("StateFeedServer: socket() failed: " + std::string(std::strerror(errno)));
+    }
+
+    sockaddr_un addr;
+    socklen_t length = makeAddress(endpointName, addr);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), length) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+        int err = errno;
+        close(listenFd);
+        throw std::runtime_error("StateFeedServer: cannot listen on " + endpointName + ": " + std::strerror(err));
+    }
+
+    loop.addFd(listenFd, [this] { acceptClients(); });
+    std::cout << "[StateFeedServer] Serving state on " << endpointName << std::endl;
+}
+
+StateFeedServer::~StateFeedServer() {
+    for (auto& [fd, client] : clients) {
+        publisher.unsubscribe(client->subscription);
+        loop.removeFd(fd);
+        close(fd);
+    }
+    loop.removeFd(listenFd);
+    close(listenFd);
+}
+
+void StateFeedServer::acceptClients() {
+    int fd;
+    while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        auto client = std::make_unique<Client>();
+        Client* raw = client.get();
+        raw->fd = fd;
+        clients.emplace(fd, std::move(client));
+        loop.addFd(fd, [this, fd] { readClient(fd); });
+
+        // The snapshot is delivered from inside subscribe()
+        raw->subscription = publisher.subscribe([this, raw](const StateFramePtr& frame) { return enqueue(*raw, frame); });
+        std::cout << "[StateFeedServer] Client connected on " << endpointName << " (" << clients.size() << " total)"
+                  << std::endl;
+    }
+}
+
+bool StateFeedServer::enqueue(Client& client, const StateFramePtr& frame) {
+    if (client.failed) {
+        return false;
+    }
+
+    if (client.backlog + frame->bytes.size() > MAX_BACKLOG_BYTES) {
+        // Keep a partly written frame so the stream stays aligned, then
+        // start over from the full table; it already includes this frame
+        StateFramePtr partial = client.offset > 0 ? client.pending.front() : nullptr;
+        client.pending.clear();
+        client.backlog = 0;
+        if (partial) {
+            client.pending.push_back(partial);
+            client.backlog = partial->bytes.size() - client.offset;
+        }
+        StateFramePtr snapshot = publisher.snapshot();
+        client.pending.push_back(snapshot);
+        client.backlog += snapshot->bytes.size();
+        ++resyncCount;
+    } else {
+        client.pending.push_back(frame);
+        client.backlog += frame->bytes.size();
+    }
+    return writeOut(client);
+}
+
+bool StateFeedServer::writeOut(Client& client) {
+    while (!client.pending.empty()) {
+        iovec iovs[MAX_IOVECS];
+        int count = 0;
+        for (auto it = client.pending.begin(); it != client.pending.end() && count < MAX_IOVECS; ++it, ++count) {
+            std::size_t skip = count == 0 ? client.offset : 0;
+            iovs[count] = { const_cast<uint8_t*>((*it)->bytes.data()) + skip, (*it)->bytes.size() - skip };
+        }
+
+        msghdr header{};
+        header.msg_iov = iovs;
+        header.msg_iovlen = static_cast<std::size_t>(count);
+        ssize_t n = sendmsg(client.fd, &header, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return true;
+            }
+            // The read callback sees the hangup and drops the client
+            client.failed = true;
+            return false;
+        }
+
+        auto written = static_cast<std::size_t>(n);
+        client.backlog -= written;
+        while (written > 0) {
+            std::size_t remaining = client.pending.front()->bytes.size() - client.offset;
+            if (written < remaining) {
+                client.offset += written;
+                return true;
+            }
+            written -= remaining;
+            client.pending.pop_front();
+            client.offset = 0;
+        }
+    }
+    return true;
+}
+
+void StateFeedServer::flush() {
+    for (auto& [fd, client] : clients) {
+        if (!client->pending.empty() && !client->failed) {
+            writeOut(*client);
+        }
+    }
+}
+
+void StateFeedServer::readClient(int fd) {
+    // Clients have nothing to say; this only notices them leaving
+    uint8_t scratch[256];
+    ssize_t n;
+    while ((n = recv(fd, scratch, sizeof(scratch), MSG_DONTWAIT)) > 0) {
+    }
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        dropClient(fd);
+    }
+}
+
+void StateFeedServer::dropClient(int fd) {
+    auto it = clients.find(fd);
+    if (it == clients.end()) {
+        return;
+    }
+    publisher.unsubscribe(it->second->subscription);
+    loop.removeFd(fd);
+    close(fd);
+    clients.erase(it);
+    std::cout << "[StateFeedServer] Client disconnected from " << endpointName << std::endl;
+}
+
+#endif // __linux__
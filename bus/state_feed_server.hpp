@@ -0,0 +1,65 @@
+// state_feed_server.hpp
+#pragma once
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "bus_loop.hpp"
+#include "state_publisher.hpp"
+
+// Serves a StatePublisher to UI processes over a SOCK_STREAM Unix socket in
+// the bus endpoints' abstract namespace. A client receives the snapshot on
+// connect and then every delta. Frames are queued per client by shared
+// pointer, so N clients cost N writev() calls over the same encoded bytes.
+//
+// There is no write readiness in BusLoop, so a client whose socket is full
+// is retried on the next frame or flush(). One that falls more than
+// MAX_BACKLOG_BYTES behind is resynced: its queue is replaced by a fresh
+// snapshot instead of growing without bound.
+class StateFeedServer {
+public:
+    static constexpr std::size_t MAX_BACKLOG_BYTES = 256 * 1024;
+
+    // Throws std::runtime_error if the endpoint cannot be bound
+    StateFeedServer(BusLoop& loop, StatePublisher& publisher, const std::string& endpointName);
+    ~StateFeedServer();
+
+    StateFeedServer(const StateFeedServer&) = delete;
+    StateFeedServer& operator=(const StateFeedServer&) = delete;
+
+    // Retry clients with queued frames. Call after each publish().
+    void flush();
+
+    std::size_t clientCount() const { return clients.size(); }
+    uint64_t resyncs() const { return resyncCount; }
+
+private:
+    static constexpr int MAX_IOVECS = 64;
+
+    struct Client {
+        int fd = -1;
+        StatePublisher::SubscriptionId subscription = 0;
+        std::deque<StateFramePtr> pending;
+        std::size_t offset = 0;     // Bytes of pending.front() already written
+        std::size_t backlog = 0;    // Unwritten bytes across pending
+        bool failed = false;
+    };
+
+    void acceptClients();
+    bool enqueue(Client& client, const StateFramePtr& frame);
+    bool writeOut(Client& client);
+    void readClient(int fd);
+    void dropClient(int fd);
+
+    BusLoop& loop;
+    StatePublisher& publisher;
+    std::string endpointName;
+    int listenFd = -1;
+    std::unordered_map<int, std::unique_ptr<Client>> clients;
+    uint64_t resyncCount = 0;
+};
+
+#endif // __linux__
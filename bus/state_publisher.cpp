@@ -0,0 +1,186 @@
+// state_publisher.cpp
+#include "state_publisher.hpp"
+#include <algorithm>
+#include "message_registry.hpp"
+
+namespace {
+
+    // Protobuf field keys for reactor::SimStateUpdate
+    constexpr uint8_t KEY_COMPONENT = (1 << 3) | 2;
+    constexpr uint8_t KEY_STATE = (2 << 3) | 2;
+    constexpr uint8_t KEY_NUMERIC_VALUE = (3 << 3) | 0;
+
+    const std::string NO_STATE;
+
+    // Largest varint plus key for each field, not counting the names
+    constexpr std::size_t MAX_ENTRY_OVERHEAD = 5 + 2 * (1 + 5) + 1 + 10;
+
+    uint8_t* putText(uint8_t* p, uint8_t key, const std::string& text) {
+        // proto3 leaves default values off the wire
+        if (text.empty()) {
+            return p;
+        }
+        *p++ = key;
+        p = detail::putVarint(p, static_cast<uint32_t>(text.size()));
+        return std::copy(text.begin(), text.end(), p);
+    }
+
+} // namespace
+
+void StatePublisher::update(SymbolId component, SymbolId state, int32_t value) {
+    if (component == NO_SYMBOL) {
+        return;
+    }
+    if (component >= table.size()) {
+        table.resize(static_cast<std::size_t>(component) + 1);
+    }
+
+    Entry& entry = table[component];
+    if (entry.present && entry.state == state && entry.value == value) {
+        return;
+    }
+    if (!entry.present) {
+        entry.present = true;
+        components.push_back(component);
+    }
+    entry.state = state;
+    entry.value = value;
+    if (!entry.dirty) {
+        entry.dirty = true;
+        dirty.push_back(component);
+    }
+    cachedSnapshot.reset();
+}
+
+void StatePublisher::apply(const Message& msg) {
+    if (msg.type == MessageType::STATE_TRANSITION) {
+        update(msg.from, phaseSymbol, PayloadTraits<StateTransition>::get(msg).phase);
+    }
+}
+
+StatePublisher::SubscriptionId StatePublisher::subscribe(Sink sink) {
+    SubscriptionId id = nextId++;
+    ++publisherStats.framesDelivered;
+    if (sink(snapshot())) {
+        sinks.emplace_back(id, std::move(sink));
+    }
+    return id;
+}
+
+void StatePublisher::unsubscribe(SubscriptionId id) {
+    sinks.erase(std::remove_if(sinks.begin(), sinks.end(), [id](const auto& entry) { return entry.first == id; }),
+                sinks.end());
+}
+
+StateFramePtr StatePublisher::publish(uint32_t tick) {
+    lastTick = tick;
+    if (dirty.empty()) {
+        return nullptr;
+    }
+
+    StateFramePtr frame = encode(StateFrame::DELTA, tick, dirty);
+    ++publisherStats.deltas;
+    for (SymbolId component : dirty) {
+        table[component].dirty = false;
+    }
+    dirty.clear();
+
+    publisherStats.framesDelivered += sinks.size();
+    sinks.erase(std::remove_if(sinks.begin(), sinks.end(), [&frame](auto& entry) { return !entry.second(frame); }),
+                sinks.end());
+    return frame;
+}
+
+StateFramePtr StatePublisher::snapshot() {
+    if (!cachedSnapshot) {
+        cachedSnapshot = encode(StateFrame::SNAPSHOT, lastTick, components);
+        ++publisherStats.snapshots;
+    } else if (cachedSnapshot->tick != lastTick) {
+        // Ticks without changes leave the entries as they were
+        cachedSnapshot = retag(*cachedSnapshot, lastTick);
+    }
+    return cachedSnapshot;
+}
+
+StateFramePtr StatePublisher::retag(const StateFrame& frame, uint32_t tick) {
+    // Everything after the tick varint is copied unchanged
+    const uint8_t* body = frame.bytes.data() + STATE_FRAME_LENGTH_BYTES + 1;
+    const uint8_t* end = frame.bytes.data() + frame.bytes.size();
+    uint32_t oldTick;
+    detail::getVarint(body, end, oldTick);
+
+    auto retagged = std::make_shared<StateFrame>();
+    retagged->kind = frame.kind;
+    retagged->tick = tick;
+    retagged->updates = frame.updates;
+    std::vector<uint8_t>& out = retagged->bytes;
+    out.resize(STATE_FRAME_LENGTH_BYTES + 1 + 5 + static_cast<std::size_t>(end - body));
+
+    uint8_t* p = out.data() + STATE_FRAME_LENGTH_BYTES;
+    *p++ = frame.kind;
+    p = detail::putVarint(p, tick);
+    p = std::copy(body, end, p);
+
+    std::size_t length = static_cast<std::size_t>(p - out.data()) - STATE_FRAME_LENGTH_BYTES;
+    out.resize(STATE_FRAME_LENGTH_BYTES + length);
+    for (std::size_t i = 0; i < STATE_FRAME_LENGTH_BYTES; ++i) {
+        out[i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+    return retagged;
+}
+
+StateFramePtr StatePublisher::encode(StateFrame::Kind kind, uint32_t tick, std::span<const SymbolId> changed) {
+    auto frame = std::make_shared<StateFrame>();
+    frame->kind = kind;
+    frame->tick = tick;
+    frame->updates = changed.size();
+
+    std::size_t capacity = STATE_FRAME_LENGTH_BYTES + 1 + 2 * 5;
+    for (SymbolId component : changed) {
+        capacity += MAX_ENTRY_OVERHEAD + symbols().name(component).size() + symbols().name(table[component].state).size();
+    }
+    std::vector<uint8_t>& out = frame->bytes;
+    out.resize(capacity);
+
+    uint8_t* p = out.data() + STATE_FRAME_LENGTH_BYTES;
+    *p++ = kind;
+    p = detail::putVarint(p, tick);
+    p = detail::putVarint(p, static_cast<uint32_t>(changed.size()));
+
+    uint8_t entry[MAX_ENTRY_OVERHEAD];
+    for (SymbolId component : changed) {
+        const Entry& state = table[component];
+        const std::string& componentName = symbols().name(component);
+        const std::string& stateName = state.state != NO_SYMBOL ? symbols().name(state.state) : NO_STATE;
+
+        // Size prefix first, so measure the entry before writing it
+        std::size_t size = 0;
+        for (const std::string* text : { &componentName, &stateName }) {
+            if (!text->empty()) {
+                size += 1 + static_cast<std::size_t>(detail::putVarint(entry, static_cast<uint32_t>(text->size())) - entry) + text->size();
+            }
+        }
+        if (state.value != 0) {
+            // int32 fields are sign-extended to 64 bits on the wire
+            size += 1 + static_cast<std::size_t>(detail::putVarint64(entry, static_cast<uint64_t>(static_cast<int64_t>(state.value))) - entry);
+        }
+
+        p = detail::putVarint(p, static_cast<uint32_t>(size));
+        p = putText(p, KEY_COMPONENT, componentName);
+        p = putText(p, KEY_STATE, stateName);
+        if (state.value != 0) {
+            *p++ = KEY_NUMERIC_VALUE;
+            p = detail::putVarint64(p, static_cast<uint64_t>(static_cast<int64_t>(state.value)));
+        }
+    }
+
+    std::size_t length = static_cast<std::size_t>(p - out.data()) - STATE_FRAME_LENGTH_BYTES;
+    out.resize(STATE_FRAME_LENGTH_BYTES + length);
+    for (std::size_t i = 0; i < STATE_FRAME_LENGTH_BYTES; ++i) {
+        out[i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+
+    publisherStats.updatesEncoded += changed.size();
+    publisherStats.bytesEncoded += out.size();
+    return frame;
+}
@@ -0,0 +1,166 @@
+// state_publisher.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "message_types.hpp"
+#include "symbol_table.hpp"
+#include "wire_format.hpp"
+
+// One encoded snapshot or delta, built once and shared read-only by every
+// subscriber it is handed to.
+//
+// bytes is a u32 little-endian body length followed by the body: a kind
+// byte, varint tick, varint update count, then per update a varint size and
+// a serialized reactor::SimStateUpdate (proto/reactor.proto). The updates
+// are written in protobuf wire format by hand, so producing the feed needs
+// no protobuf runtime but any protobuf client can parse the entries.
+struct StateFrame {
+    enum Kind : uint8_t {
+        SNAPSHOT = 1,
+        DELTA = 2
+    };
+
+    Kind kind = DELTA;
+    uint32_t tick = 0;
+    std::size_t updates = 0;
+    std::vector<uint8_t> bytes;
+};
+
+using StateFramePtr = std::shared_ptr<const StateFrame>;
+
+inline constexpr std::size_t STATE_FRAME_LENGTH_BYTES = 4;
+
+// Authoritative table of simulated component state for UI subscribers. A
+// new subscriber is sent a snapshot of the whole table; after that each
+// publish() sends one delta holding only the components that changed since
+// the previous one. The delta is encoded once and the same buffer goes to
+// every subscriber, so per-tick cost follows the rate of change rather than
+// subscribers times panel size. Snapshots are encoded only when someone
+// joins and are reused until the table next changes; a later tick only
+// rewrites the cached frame's tick.
+//
+// Tick thread only.
+class StatePublisher {
+public:
+    using SubscriptionId = uint32_t;
+
+    // Called with each frame for the subscriber; return false to unsubscribe.
+    // Must not subscribe or unsubscribe from inside the call.
+    using Sink = std::function<bool(const StateFramePtr&)>;
+
+    struct Stats {
+        uint64_t deltas = 0;
+        uint64_t snapshots = 0;
+        uint64_t updatesEncoded = 0;    // Component entries serialized, both kinds
+        uint64_t bytesEncoded = 0;
+        uint64_t framesDelivered = 0;   // Frames handed to sinks
+    };
+
+    StatePublisher() : phaseSymbol(symbols().intern("phase")) {}
+
+    // Record a component's state. Only a real change is sent in the next delta.
+    void update(SymbolId component, SymbolId state, int32_t value);
+
+    // A StateTransition sets the sender's "phase"; other types are ignored
+    void apply(const Message& msg);
+
+    // Send sink the current snapshot now and every delta after it
+    SubscriptionId subscribe(Sink sink);
+    void unsubscribe(SubscriptionId id);
+
+    // Encode the changes since the last publish and hand the frame to every
+    // subscriber. Returns null if nothing changed.
+    StateFramePtr publish(uint32_t tick);
+
+    // The whole table, tagged with the last published tick
+    StateFramePtr snapshot();
+
+    std::size_t componentCount() const { return components.size(); }
+    std::size_t subscriberCount() const { return sinks.size(); }
+    const Stats& stats() const { return publisherStats; }
+
+private:
+    struct Entry {
+        SymbolId state = NO_SYMBOL;
+        int32_t value = 0;
+        bool present = false;
+        bool dirty = false;
+    };
+
+    StateFramePtr encode(StateFrame::Kind kind, uint32_t tick, std::span<const SymbolId> changed);
+    static StateFramePtr retag(const StateFrame& frame, uint32_t tick);
+
+    SymbolId phaseSymbol;
+    std::vector<Entry> table;               // Indexed by component SymbolId
+    std::vector<SymbolId> components;       // Present entries, in first-seen order
+    std::vector<SymbolId> dirty;
+    std::vector<std::pair<SubscriptionId, Sink>> sinks;
+    SubscriptionId nextId = 1;
+    uint32_t lastTick = 0;
+    StateFramePtr cachedSnapshot;           // Reset by any change
+    Stats publisherStats;
+};
+
+// Walk the frame at the start of in, calling f(component, state, value) for
+// each update. The names point into in. Returns false if the frame is
+// truncated or malformed.
+template <typename F>
+bool forEachStateUpdate(std::span<const uint8_t> in, StateFrame::Kind& kind, uint32_t& tick, F&& f) {
+    if (in.size() < STATE_FRAME_LENGTH_BYTES) {
+        return false;
+    }
+    std::size_t length = static_cast<std::size_t>(in[0]) | (static_cast<std::size_t>(in[1]) << 8) |
+                         (static_cast<std::size_t>(in[2]) << 16) | (static_cast<std::size_t>(in[3]) << 24);
+    if (in.size() - STATE_FRAME_LENGTH_BYTES < length || length == 0) {
+        return false;
+    }
+    const uint8_t* p = in.data() + STATE_FRAME_LENGTH_BYTES;
+    const uint8_t* end = p + length;
+    kind = static_cast<StateFrame::Kind>(*p++);
+    uint32_t count;
+    if (!detail::getVarint(p, end, tick) || !detail::getVarint(p, end, count)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t size;
+        if (!detail::getVarint(p, end, size) || static_cast<std::size_t>(end - p) < size) {
+            return false;
+        }
+        const uint8_t* entryEnd = p + size;
+        std::string_view component;
+        std::string_view state;
+        int32_t value = 0;
+        while (p < entryEnd) {
+            uint32_t key;
+            if (!detail::getVarint(p, entryEnd, key)) {
+                return false;
+            }
+            if (key == ((1 << 3) | 2) || key == ((2 << 3) | 2)) {
+                uint32_t textSize;
+                if (!detail::getVarint(p, entryEnd, textSize) || static_cast<std::size_t>(entryEnd - p) < textSize) {
+                    return false;
+                }
+                std::string_view text(reinterpret_cast<const char*>(p), textSize);
+                (key >> 3 == 1 ? component : state) = text;
+                p += textSize;
+            } else if (key == ((3 << 3) | 0)) {
+                uint64_t raw;
+                if (!detail::getVarint64(p, entryEnd, raw)) {
+                    return false;
+                }
+                value = static_cast<int32_t>(raw);
+            } else {
+                return false;
+            }
+        }
+        f(component, state, value);
+    }
+    return p == end;
+}
@@ -0,0 +1,84 @@
+// symbol_table.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Small integer handle for an interned name (controller, pin alias, subsystem)
+using SymbolId = uint16_t;
+
+// Id 0 is reserved for "no symbol"
+inline constexpr SymbolId NO_SYMBOL = 0;
+
+// Process-wide table mapping names to SymbolIds and back.
+// Names are interned at config load; after that messages carry only ids.
+// Reverse lookups (name) are lock-free so the bus and debug console can
+// call them from any thread.
+class SymbolTable {
+public:
+    static constexpr std::size_t MAX_SYMBOLS = 4096;
+
+    SymbolTable() : names(std::make_unique<std::string[]>(MAX_SYMBOLS)) {
+        names[NO_SYMBOL] = "<none>";
+        count.store(1, std::memory_order_release);
+    }
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // Return the id for name, assigning a new one if it is not yet known
+    SymbolId intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(internMutex);
+        auto it = ids.find(std::string(name));
+        if (it != ids.end()) {
+            return it->second;
+        }
+
+        std::size_t next = count.load(std::memory_order_relaxed);
+        if (next >= MAX_SYMBOLS) {
+            throw std::runtime_error("Symbol table full while interning: " + std::string(name));
+        }
+
+        SymbolId id = static_cast<SymbolId>(next);
+        names[id] = std::string(name);
+        ids.emplace(names[id], id);
+        count.store(next + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Return the id for name, or NO_SYMBOL if it was never interned
+    SymbolId find(std::string_view name) const {
+        std::lock_guard<std::mutex> lock(internMutex);
+        auto it = ids.find(std::string(name));
+        return it != ids.end() ? it->second : NO_SYMBOL;
+    }
+
+    // Map an id back to its name for logging
+    const std::string& name(SymbolId id) const {
+        static const std::string unknown = "<unknown>";
+        if (id >= count.load(std::memory_order_acquire)) {
+            return unknown;
+        }
+        return names[id];
+    }
+
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<std::string[]> names;
+    std::atomic<std::size_t> count{0};
+    std::unordered_map<std::string, SymbolId> ids;
+    mutable std::mutex internMutex;
+};
+
+// Global symbol table shared by the bus, config loader and UI
+inline SymbolTable& symbols() {
+    static SymbolTable table;
+    return table;
+}
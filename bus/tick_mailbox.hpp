@@ -0,0 +1,73 @@
+// tick_mailbox.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "lane_queue.hpp"
+#include "message_types.hpp"
+
+// Front/back message buffers for one tick boundary. Producers post into the
+// back buffer during tick N; swap() makes those messages the stable front
+// buffer for tick N+1 and recycles the old front as the new back. Both
+// buffers are allocated once, so swapping never reallocates or copies.
+//
+// Each buffer is split into one segment per priority lane so readers can
+// walk the front buffer in strict priority order.
+class TickMailbox {
+public:
+    explicit TickMailbox(const LaneCapacities& capacities) {
+        for (std::size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            laneCapacity[lane] = capacities[static_cast<Lane>(lane)];
+            for (auto& buffer : buffers) {
+                buffer[lane] = std::make_unique<Message[]>(laneCapacity[lane]);
+            }
+        }
+    }
+
+    TickMailbox(const TickMailbox&) = delete;
+    TickMailbox& operator=(const TickMailbox&) = delete;
+
+    // Returns false (and drops the message) if the lane's back segment is full
+    bool post(const Message& msg) {
+        std::size_t lane = laneIndex(msg.lane);
+        std::size_t& count = counts[frontIndex ^ 1][lane];
+        if (count >= laneCapacity[lane]) {
+            return false;
+        }
+        buffers[frontIndex ^ 1][lane][count++] = msg;
+        return true;
+    }
+
+    // O(1): the back buffer becomes the front, the old front is emptied
+    void swap() {
+        frontIndex ^= 1;
+        for (std::size_t& count : counts[frontIndex ^ 1]) {
+            count = 0;
+        }
+    }
+
+    std::span<const Message> front(Lane lane) const {
+        std::size_t i = laneIndex(lane);
+        return { buffers[frontIndex][i].get(), counts[frontIndex][i] };
+    }
+
+    std::size_t frontSize() const {
+        std::size_t total = 0;
+        for (std::size_t count : counts[frontIndex]) {
+            total += count;
+        }
+        return total;
+    }
+
+    bool backFull(Lane lane) const {
+        std::size_t i = laneIndex(lane);
+        return counts[frontIndex ^ 1][i] >= laneCapacity[i];
+    }
+
+private:
+    std::size_t laneCapacity[LANE_COUNT] = {};
+    std::unique_ptr<Message[]> buffers[2][LANE_COUNT];
+    std::size_t counts[2][LANE_COUNT] = {};
+    uint8_t frontIndex = 0;
+};
@@ -0,0 +1,407 @@
+// trace_compact.cpp
+#ifdef __linux__
+#include "trace_compact.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "wire_format.hpp"
+
+namespace {
+
+    // Run header plus the largest record: 5 + 3 + 3 + 3, then 10 + 5 + 5 + 5
+    // + 10 and a payload of at most 10
+    constexpr std::size_t MAX_ENCODED_RECORD = 64;
+
+    bool sameRoute(const TraceRecord& a, const TraceRecord& b) {
+        return a.point == b.point && a.msg.type == b.msg.type && a.msg.lane == b.msg.lane &&
+               a.msg.flags == b.msg.flags && a.msg.from == b.msg.from && a.msg.to == b.msg.to;
+    }
+
+} // namespace
+
+void encodeCompactBlock(std::span<const TraceRecord> records, std::vector<uint8_t>& out) {
+    if (records.empty()) {
+        return;
+    }
+    std::size_t start = out.size();
+    out.resize(start + records.size() * MAX_ENCODED_RECORD);
+    uint8_t* p = out.data() + start;
+
+    uint64_t prevNs = records.front().timestampNs;
+    int64_t prevDelta = 0;
+    uint32_t prevTick = records.front().tick;
+    uint32_t prevSeq = 0;
+    for (std::size_t i = 0; i < records.size();) {
+        // One run per stretch of records with the same route
+        const TraceRecord& first = records[i];
+        std::size_t runEnd = i + 1;
+        while (runEnd < records.size() && sameRoute(records[runEnd], first)) {
+            ++runEnd;
+        }
+        p = detail::putVarint(p, static_cast<uint32_t>(runEnd - i));
+        *p++ = static_cast<uint8_t>((static_cast<uint8_t>(first.point) << 4) | static_cast<uint8_t>(first.msg.lane));
+        *p++ = static_cast<uint8_t>(first.msg.type);
+        *p++ = first.msg.flags;
+        p = detail::putVarint(p, first.msg.from);
+        p = detail::putVarint(p, first.msg.to);
+
+        for (; i < runEnd; ++i) {
+            const TraceRecord& record = records[i];
+            const Message& msg = record.msg;
+            int64_t delta = static_cast<int64_t>(record.timestampNs - prevNs);
+            p = detail::putVarint64(p, detail::zigzag64(delta - prevDelta));
+            prevNs = record.timestampNs;
+            prevDelta = delta;
+
+            p = detail::putVarint(p, detail::zigzag(static_cast<int32_t>(record.tick - prevTick)));
+            prevTick = record.tick;
+            p = detail::putVarint(p, msg.tick == 0 ? 0 : detail::zigzag(static_cast<int32_t>(msg.tick - record.tick)) + 1);
+            p = detail::putVarint(p, detail::zigzag(static_cast<int32_t>(msg.seq - prevSeq - 1)));
+            prevSeq = msg.seq;
+            p = detail::putVarint64(p, msg.enqueueNs == 0 ? 0
+                : detail::zigzag64(static_cast<int64_t>(record.timestampNs - msg.enqueueNs)) + 1);
+            dispatchMessage(msg, [&p](const auto& payload) {
+                p = WireCodec<std::decay_t<decltype(payload)>>::encode(p, payload);
+            });
+        }
+    }
+    out.resize(static_cast<std::size_t>(p - out.data()));
+}
+
+bool decodeCompactBlock(const CompactBlockHeader& header, std::span<const uint8_t> body, std::vector<TraceRecord>& out) {
+    out.resize(header.recordCount);
+    const uint8_t* p = body.data();
+    const uint8_t* end = p + body.size();
+
+    uint64_t prevNs = header.firstNs;
+    int64_t prevDelta = 0;
+    uint32_t prevTick = header.firstTick;
+    uint32_t prevSeq = 0;
+    std::size_t i = 0;
+    while (i < out.size()) {
+        uint32_t runLength;
+        if (!detail::getVarint(p, end, runLength) || runLength == 0 || runLength > out.size() - i ||
+            end - p < 3) {
+            return false;
+        }
+        uint8_t pointLane = *p++;
+        uint8_t type = *p++;
+        uint8_t flags = *p++;
+        if ((pointLane >> 4) > static_cast<uint8_t>(TapPoint::OUTBOUND) || (pointLane & 0x0F) >= LANE_COUNT ||
+            type >= MESSAGE_TYPE_COUNT) {
+            return false;
+        }
+        Message route;
+        route.type = static_cast<MessageType>(type);
+        route.lane = static_cast<Lane>(pointLane & 0x0F);
+        route.flags = flags;
+        if (!detail::getSymbol(p, end, route.from) || !detail::getSymbol(p, end, route.to)) {
+            return false;
+        }
+
+        for (std::size_t runEnd = i + runLength; i < runEnd; ++i) {
+            TraceRecord& record = out[i];
+            record = TraceRecord{};
+            record.point = static_cast<TapPoint>(pointLane >> 4);
+            Message& msg = record.msg;
+            msg = route;
+
+            uint64_t dod;
+            uint32_t tickDelta;
+            uint32_t msgTick;
+            uint32_t seq;
+            uint64_t enqueue;
+            if (!detail::getVarint64(p, end, dod) || !detail::getVarint(p, end, tickDelta) ||
+                !detail::getVarint(p, end, msgTick) || !detail::getVarint(p, end, seq) ||
+                !detail::getVarint64(p, end, enqueue)) {
+                return false;
+            }
+            prevDelta += detail::unzigzag64(dod);
+            prevNs += static_cast<uint64_t>(prevDelta);
+            record.timestampNs = prevNs;
+            prevTick += static_cast<uint32_t>(detail::unzigzag(tickDelta));
+            record.tick = prevTick;
+            msg.tick = msgTick == 0 ? 0 : record.tick + static_cast<uint32_t>(detail::unzigzag(msgTick - 1));
+            prevSeq += static_cast<uint32_t>(detail::unzigzag(seq)) + 1;
+            msg.seq = prevSeq;
+            msg.enqueueNs = enqueue == 0 ? 0 : record.timestampNs - static_cast<uint64_t>(detail::unzigzag64(enqueue - 1));
+            if (!detail::decodePayload(RegisteredPayloads{}, msg.type, p, end, msg)) {
+                return false;
+            }
+        }
+    }
+    return p == end;
+}
+
+CompactTraceWriter::CompactTraceWriter(std::string path, uint32_t segmentIndex, uint32_t lastTick, std::size_t blockRecords)
+    : filePath(std::move(path)), buildingPath(filePath + ".tmp"), blockRecords(blockRecords) {
+    if (blockRecords == 0 || blockRecords > UINT32_MAX) {
+        throw std::runtime_error("CompactTraceWriter: blockRecords out of range");
+    }
+    fd = open(buildingPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("CompactTraceWriter: cannot create " + buildingPath + ": " + std::strerror(errno));
+    }
+    pending.reserve(blockRecords);
+
+    CompactTraceHeader header{};
+    std::memcpy(header.magic, COMPACT_TRACE_MAGIC, sizeof(COMPACT_TRACE_MAGIC));
+    header.version = COMPACT_TRACE_VERSION;
+    header.blockRecords = static_cast<uint32_t>(blockRecords);
+    header.segmentIndex = segmentIndex;
+    header.headerSize = sizeof(CompactTraceHeader);
+    header.lastTick = lastTick;
+    writeAll(&header, sizeof(header));
+}
+
+CompactTraceWriter::~CompactTraceWriter() {
+    close();
+}
+
+void CompactTraceWriter::append(const TraceRecord& record) {
+    pending.push_back(record);
+    if (pending.size() == blockRecords) {
+        flushBlock();
+    }
+}
+
+void CompactTraceWriter::flushBlock() {
+    if (pending.empty()) {
+        return;
+    }
+    body.clear();
+    encodeCompactBlock(pending, body);
+
+    CompactBlockHeader header{};
+    header.bodySize = static_cast<uint32_t>(body.size());
+    header.recordCount = static_cast<uint32_t>(pending.size());
+    header.firstRecord = recordTotal;
+    header.firstNs = pending.front().timestampNs;
+    header.firstTick = pending.front().tick;
+    index.push_back({ offset, header.firstRecord, header.firstNs, header.firstTick, header.recordCount });
+
+    writeAll(&header, sizeof(header));
+    writeAll(body.data(), body.size());
+    recordTotal += pending.size();
+    pending.clear();
+}
+
+void CompactTraceWriter::writeAll(const void* data, std::size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0 && !failed) {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            std::cerr << "[CompactTraceWriter] Cannot write " << buildingPath << ": " << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+        }
+        p += n;
+        size -= static_cast<std::size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+}
+
+bool CompactTraceWriter::close() {
+    if (fd < 0) {
+        return !failed;
+    }
+    flushBlock();
+    CompactTraceFooter footer{};
+    footer.indexOffset = offset;
+    footer.blockCount = index.size();
+    footer.recordCount = recordTotal;
+    std::memcpy(footer.magic, COMPACT_INDEX_MAGIC, sizeof(COMPACT_INDEX_MAGIC));
+    writeAll(index.data(), index.size() * sizeof(CompactBlockIndex));
+    writeAll(&footer, sizeof(footer));
+
+    ::close(fd);
+    fd = -1;
+    if (!failed && rename(buildingPath.c_str(), filePath.c_str()) != 0) {
+        std::cerr << "[CompactTraceWriter] Cannot rename " << buildingPath << ": " << std::strerror(errno) << std::endl;
+        failed = true;
+    }
+    if (failed) {
+        unlink(buildingPath.c_str());
+    }
+    return !failed;
+}
+
+CompactTrace::CompactTrace(const std::string& path) : filePath(path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("CompactTrace: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(CompactTraceHeader)) {
+        ::close(fd);
+        throw std::runtime_error("CompactTrace: " + path + " is too short to be a compact trace");
+    }
+
+    mappingSize = static_cast<std::size_t>(info.st_size);
+    void* base = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("CompactTrace: cannot map " + path + ": " + std::strerror(errno));
+    }
+    mapping = static_cast<const uint8_t*>(base);
+
+    const CompactTraceHeader& h = header();
+    if (std::memcmp(h.magic, COMPACT_TRACE_MAGIC, sizeof(COMPACT_TRACE_MAGIC)) != 0 ||
+        h.version != COMPACT_TRACE_VERSION || h.headerSize != sizeof(CompactTraceHeader)) {
+        munmap(base, mappingSize);
+        mapping = nullptr;
+        throw std::runtime_error("CompactTrace: " + path + " is not a version " +
+                                 std::to_string(COMPACT_TRACE_VERSION) + " compact trace");
+    }
+    loadIndex();
+}
+
+CompactTrace::~CompactTrace() {
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), mappingSize);
+    }
+}
+
+CompactTrace::CompactTrace(CompactTrace&& other) noexcept
+    : filePath(std::move(other.filePath)),
+      mapping(std::exchange(other.mapping, nullptr)),
+      mappingSize(std::exchange(other.mappingSize, 0)),
+      index(std::move(other.index)),
+      totalRecords(std::exchange(other.totalRecords, 0)) {}
+
+CompactTrace& CompactTrace::operator=(CompactTrace&& other) noexcept {
+    if (this != &other) {
+        if (mapping) {
+            munmap(const_cast<uint8_t*>(mapping), mappingSize);
+        }
+        filePath = std::move(other.filePath);
+        mapping = std::exchange(other.mapping, nullptr);
+        mappingSize = std::exchange(other.mappingSize, 0);
+        index = std::move(other.index);
+        totalRecords = std::exchange(other.totalRecords, 0);
+    }
+    return *this;
+}
+
+void CompactTrace::loadIndex() {
+    if (mappingSize >= sizeof(CompactTraceHeader) + sizeof(CompactTraceFooter)) {
+        CompactTraceFooter footer;
+        std::memcpy(&footer, mapping + mappingSize - sizeof(footer), sizeof(footer));
+        if (std::memcmp(footer.magic, COMPACT_INDEX_MAGIC, sizeof(COMPACT_INDEX_MAGIC)) == 0 &&
+            footer.indexOffset <= mappingSize - sizeof(footer) &&
+            footer.blockCount == (mappingSize - sizeof(footer) - footer.indexOffset) / sizeof(CompactBlockIndex)) {
+            index.resize(footer.blockCount);
+            std::memcpy(index.data(), mapping + footer.indexOffset, index.size() * sizeof(CompactBlockIndex));
+            totalRecords = footer.recordCount;
+            return;
+        }
+    }
+
+    // No usable footer: walk the blocks that were written completely
+    std::cerr << "[CompactTrace] " << filePath << " has no index, scanning its blocks" << std::endl;
+    std::size_t offset = sizeof(CompactTraceHeader);
+    while (mappingSize - offset >= sizeof(CompactBlockHeader)) {
+        CompactBlockHeader block;
+        std::memcpy(&block, mapping + offset, sizeof(block));
+        if (block.recordCount == 0 || block.firstRecord != totalRecords ||
+            block.bodySize > mappingSize - offset - sizeof(block)) {
+            break;
+        }
+        index.push_back({ offset, block.firstRecord, block.firstNs, block.firstTick, block.recordCount });
+        totalRecords += block.recordCount;
+        offset += sizeof(block) + block.bodySize;
+    }
+}
+
+bool CompactTrace::decodeBlock(std::size_t block, std::vector<TraceRecord>& out) const {
+    const CompactBlockIndex& entry = index[block];
+    CompactBlockHeader header;
+    bool ok = entry.offset <= mappingSize - sizeof(header);
+    if (ok) {
+        std::memcpy(&header, mapping + entry.offset, sizeof(header));
+        ok = header.recordCount == entry.recordCount && header.firstRecord == entry.firstRecord &&
+             header.bodySize <= mappingSize - entry.offset - sizeof(header) &&
+             decodeCompactBlock(header, { mapping + entry.offset + sizeof(header), header.bodySize }, out);
+    }
+    if (!ok) {
+        std::cerr << "[CompactTrace] " << filePath << ": block " << block << " is corrupt" << std::endl;
+        out.clear();
+    }
+    return ok;
+}
+
+std::size_t CompactTrace::blockForRecord(uint64_t n) const {
+    if (n >= totalRecords) {
+        return index.size();
+    }
+    auto it = std::upper_bound(index.begin(), index.end(), n,
+                               [](uint64_t record, const CompactBlockIndex& entry) { return record < entry.firstRecord; });
+    return static_cast<std::size_t>(it - index.begin()) - 1;
+}
+
+std::size_t CompactTrace::blockForTime(uint64_t ns) const {
+    auto it = std::upper_bound(index.begin(), index.end(), ns,
+                               [](uint64_t time, const CompactBlockIndex& entry) { return time < entry.firstNs; });
+    return it == index.begin() ? 0 : static_cast<std::size_t>(it - index.begin()) - 1;
+}
+
+bool CompactTraceDecoder::load(std::size_t block) {
+    cursor = 0;
+    nextBlock = block + 1;
+    if (!trace.decodeBlock(block, decoded)) {
+        // Nothing past a corrupt block can be trusted
+        nextBlock = trace.blocks().size();
+        return false;
+    }
+    return true;
+}
+
+bool CompactTraceDecoder::next(TraceRecord& record) {
+    while (cursor == decoded.size()) {
+        if (nextBlock >= trace.blocks().size() || !load(nextBlock)) {
+            return false;
+        }
+    }
+    record = decoded[cursor++];
+    ++pos;
+    return true;
+}
+
+void CompactTraceDecoder::seekRecord(uint64_t n) {
+    std::size_t block = trace.blockForRecord(n);
+    decoded.clear();
+    cursor = 0;
+    nextBlock = block;
+    pos = std::min(n, trace.recordCount());
+    if (block < trace.blocks().size() && load(block)) {
+        cursor = static_cast<std::size_t>(n - trace.blocks()[block].firstRecord);
+    }
+}
+
+void CompactTraceDecoder::seekTime(uint64_t ns) {
+    std::size_t block = trace.blockForTime(ns);
+    decoded.clear();
+    cursor = 0;
+    nextBlock = block;
+    pos = block < trace.blocks().size() ? trace.blocks()[block].firstRecord : trace.recordCount();
+    if (block < trace.blocks().size() && load(block)) {
+        auto it = std::lower_bound(decoded.begin(), decoded.end(), ns,
+                                   [](const TraceRecord& record, uint64_t time) { return record.timestampNs < time; });
+        cursor = static_cast<std::size_t>(it - decoded.begin());
+        pos += cursor;
+    }
+}
+
+#endif // __linux__
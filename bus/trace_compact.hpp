@@ -0,0 +1,149 @@
+// trace_compact.hpp
+#pragma once
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "trace_format.hpp"
+
+// Encode records as one compact block body (trace_format.hpp), appending to
+// out. Timestamp deltas start from the first record's.
+void encodeCompactBlock(std::span<const TraceRecord> records, std::vector<uint8_t>& out);
+
+// Decode a block body into out, replacing its contents. Returns false if the
+// body is malformed or does not hold exactly header.recordCount records.
+bool decodeCompactBlock(const CompactBlockHeader& header, std::span<const uint8_t> body, std::vector<TraceRecord>& out);
+
+// Streams records into a compact segment file. Records are buffered until a
+// block fills, then encoded and written, so memory stays at one block
+// however long the segment. The file is built under path + ".tmp" and moved
+// into place by close(), so readers never see one without its index.
+class CompactTraceWriter {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_RECORDS = 1024;
+
+    // Throws std::runtime_error if the file cannot be created. lastTick is
+    // copied to the header, as TraceSegmentHeader::lastTick.
+    CompactTraceWriter(std::string path, uint32_t segmentIndex = 0, uint32_t lastTick = 0,
+                       std::size_t blockRecords = DEFAULT_BLOCK_RECORDS);
+    ~CompactTraceWriter();
+
+    CompactTraceWriter(const CompactTraceWriter&) = delete;
+    CompactTraceWriter& operator=(const CompactTraceWriter&) = delete;
+
+    void append(const TraceRecord& record);
+
+    // Write the last block, the index and the footer. Returns false if any
+    // write failed, in which case the file is removed. The destructor calls
+    // it.
+    bool close();
+
+    uint64_t records() const { return recordTotal; }
+    uint64_t bytes() const { return offset; }     // Written so far
+
+private:
+    void flushBlock();
+    void writeAll(const void* data, std::size_t size);
+
+    std::string filePath;
+    std::string buildingPath;
+    int fd = -1;
+    std::size_t blockRecords;
+    bool failed = false;
+
+    std::vector<TraceRecord> pending;
+    std::vector<uint8_t> body;
+    std::vector<CompactBlockIndex> index;
+    uint64_t offset = 0;
+    uint64_t recordTotal = 0;
+};
+
+// One compact segment mapped read-only, with its block index. A file without
+// a footer (the writer died before close()) is indexed by walking its block
+// headers up to the first incomplete one.
+class CompactTrace {
+public:
+    // Throws std::runtime_error if the file is missing or not a compact trace
+    explicit CompactTrace(const std::string& path);
+    ~CompactTrace();
+
+    CompactTrace(CompactTrace&& other) noexcept;
+    CompactTrace& operator=(CompactTrace&& other) noexcept;
+    CompactTrace(const CompactTrace&) = delete;
+    CompactTrace& operator=(const CompactTrace&) = delete;
+
+    const CompactTraceHeader& header() const { return *reinterpret_cast<const CompactTraceHeader*>(mapping); }
+    std::span<const CompactBlockIndex> blocks() const { return index; }
+    uint64_t recordCount() const { return totalRecords; }
+    const std::string& path() const { return filePath; }
+
+    // Decode block i into out, replacing its contents. Returns false (and
+    // logs) if the block is corrupt.
+    bool decodeBlock(std::size_t block, std::vector<TraceRecord>& out) const;
+
+    // Block holding record n; blocks().size() if n is past the end
+    std::size_t blockForRecord(uint64_t n) const;
+
+    // Last block starting at or before ns, where a record at ns would be
+    std::size_t blockForTime(uint64_t ns) const;
+
+    // Visit records in order, as const TraceRecord&, valid only during the
+    // call, until f returns false. Stops and returns false at a corrupt
+    // block; blocks after the one f stopped in are never decoded.
+    template <typename F>
+    bool forEach(F&& f) const {
+        std::vector<TraceRecord> decoded;
+        for (std::size_t i = 0; i < index.size(); ++i) {
+            if (!decodeBlock(i, decoded)) {
+                return false;
+            }
+            for (const TraceRecord& record : decoded) {
+                if (!f(record)) {
+                    return true;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    void loadIndex();
+
+    std::string filePath;
+    const uint8_t* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    std::vector<CompactBlockIndex> index;
+    uint64_t totalRecords = 0;
+};
+
+// Sequential reader over a CompactTrace that can seek by record or time.
+// Decodes one block at a time, so a seek costs at most one block.
+class CompactTraceDecoder {
+public:
+    explicit CompactTraceDecoder(const CompactTrace& trace) : trace(trace) {}
+
+    // The next record; false at the end or at a corrupt block
+    bool next(TraceRecord& record);
+
+    // Continue from record n
+    void seekRecord(uint64_t n);
+
+    // Continue from the first record at or after ns
+    void seekTime(uint64_t ns);
+
+    // Record next() returns
+    uint64_t position() const { return pos; }
+
+private:
+    bool load(std::size_t block);
+
+    const CompactTrace& trace;
+    std::vector<TraceRecord> decoded;
+    std::size_t cursor = 0;         // Into decoded
+    std::size_t nextBlock = 0;      // Loaded once decoded runs out
+    uint64_t pos = 0;
+};
+
+#endif // __linux__
@@ -0,0 +1,108 @@
+// trace_format.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "message_bus.hpp"
+#include "message_types.hpp"
+
+// On-disk layout of bus trace segments (trace_recorder.hpp writes them,
+// trace_reader.hpp reads them). A segment is a TraceSegmentHeader followed
+// by a preallocated array of fixed-size TraceRecords, so a reader can map
+// the file and index records directly. Native byte order; traces are read
+// on the machine that wrote them or one like it.
+
+inline constexpr char TRACE_MAGIC[8] = { 'F', 'R', 'T', 'R', 'A', 'C', 'E', '1' };
+inline constexpr uint32_t TRACE_VERSION = 1;
+
+struct TraceRecord {
+    uint64_t timestampNs;   // busClockNs() when the tap saw the message
+    uint32_t tick;          // Tick that observed or produced it
+    TapPoint point;
+    uint8_t reserved[3];
+    Message msg;
+};
+
+static_assert(std::is_trivially_copyable_v<TraceRecord>, "TraceRecord is written to disk as-is");
+static_assert(sizeof(TraceRecord) == 48, "TraceRecord layout changed; bump TRACE_VERSION");
+
+struct TraceSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t headerSize;        // Records start here
+    uint32_t segmentIndex;      // Position in the trace, from 0
+    uint64_t capacity;          // Records the file has room for
+    uint64_t recordCount;       // Records written so far; advanced as the writer goes
+    uint64_t firstNs;
+    uint64_t lastNs;
+    uint32_t lastTick;          // Final tick of the run, in its last segment; 0 if unknown
+    uint8_t reserved[4];
+};
+
+static_assert(sizeof(TraceSegmentHeader) == 64, "TraceSegmentHeader must stay one cache line");
+
+// Compact segments, <prefix>-NNNNNN.ctrace (trace_compact.hpp), hold the
+// same records in a fraction of the space:
+//
+//   CompactTraceHeader
+//   block*             CompactBlockHeader + encoded body
+//   CompactBlockIndex  one per block
+//   CompactTraceFooter
+//
+// A block body is a sequence of route runs. Each run is a varint length, a
+// byte of point << 4 | lane, type, flags, and varint from and to; then per
+// record, as zigzag varints:
+//   timestamp   delta of delta, both reset at the block start
+//   tick        delta from the previous record
+//   msg.tick    0 if unset (traffic from the wire), else 1 + difference
+//               from the record's tick
+//   seq         delta from the previous record, minus one
+//   enqueueNs   0 if unset, else 1 + (timestamp - enqueueNs)
+//   payload     as in wire_format.hpp (WireCodec)
+// Blocks are self-contained, so the index is enough to seek to any record or
+// time; a file cut short before its footer can still be scanned block by
+// block. TraceRecord::reserved and Message::wireBytes are not kept.
+
+inline constexpr char COMPACT_TRACE_MAGIC[8] = { 'F', 'R', 'C', 'T', 'R', 'C', 'E', '1' };
+inline constexpr char COMPACT_INDEX_MAGIC[8] = { 'F', 'R', 'C', 'I', 'N', 'D', 'X', '1' };
+inline constexpr uint32_t COMPACT_TRACE_VERSION = 1;
+
+struct CompactTraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockRecords;      // Records per block, except the last
+    uint32_t segmentIndex;
+    uint32_t headerSize;
+    uint32_t lastTick;          // As in TraceSegmentHeader
+    uint8_t reserved[4];
+};
+
+struct CompactBlockHeader {
+    uint32_t bodySize;
+    uint32_t recordCount;
+    uint64_t firstRecord;       // Position of the block's first record in the segment
+    uint64_t firstNs;
+    uint32_t firstTick;
+    uint32_t reserved;
+};
+
+struct CompactBlockIndex {
+    uint64_t offset;            // Of the block's header from the start of the file
+    uint64_t firstRecord;
+    uint64_t firstNs;
+    uint32_t firstTick;
+    uint32_t recordCount;
+};
+
+struct CompactTraceFooter {
+    uint64_t indexOffset;
+    uint64_t blockCount;
+    uint64_t recordCount;
+    char magic[8];
+};
+
+static_assert(sizeof(CompactTraceHeader) == 32, "CompactTraceHeader layout changed; bump COMPACT_TRACE_VERSION");
+static_assert(sizeof(CompactBlockHeader) == 32, "CompactBlockHeader layout changed; bump COMPACT_TRACE_VERSION");
+static_assert(sizeof(CompactBlockIndex) == 32, "CompactBlockIndex layout changed; bump COMPACT_TRACE_VERSION");
+static_assert(sizeof(CompactTraceFooter) == 32, "CompactTraceFooter layout changed; bump COMPACT_TRACE_VERSION");
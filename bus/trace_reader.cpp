@@ -0,0 +1,133 @@
+// trace_reader.cpp
+#ifdef __linux__
+#include "trace_reader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TraceSegment::TraceSegment(const std::string& path) : filePath(path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("TraceSegment: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(TraceSegmentHeader)) {
+        ::close(fd);
+        throw std::runtime_error("TraceSegment: " + path + " is too short to be a trace");
+    }
+
+    mappingSize = static_cast<std::size_t>(info.st_size);
+    void* base = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("TraceSegment: cannot map " + path + ": " + std::strerror(errno));
+    }
+    mapping = static_cast<const uint8_t*>(base);
+    madvise(base, mappingSize, MADV_SEQUENTIAL);
+
+    const TraceSegmentHeader& h = header();
+    if (std::memcmp(h.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || h.version != TRACE_VERSION ||
+        h.recordSize != sizeof(TraceRecord) || h.headerSize != sizeof(TraceSegmentHeader)) {
+        munmap(base, mappingSize);
+        mapping = nullptr;
+        throw std::runtime_error("TraceSegment: " + path + " is not a version " + std::to_string(TRACE_VERSION) + " trace");
+    }
+}
+
+TraceSegment::~TraceSegment() {
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), mappingSize);
+    }
+}
+
+TraceSegment::TraceSegment(TraceSegment&& other) noexcept
+    : filePath(std::move(other.filePath)),
+      mapping(std::exchange(other.mapping, nullptr)),
+      mappingSize(std::exchange(other.mappingSize, 0)) {}
+
+TraceSegment& TraceSegment::operator=(TraceSegment&& other) noexcept {
+    if (this != &other) {
+        if (mapping) {
+            munmap(const_cast<uint8_t*>(mapping), mappingSize);
+        }
+        filePath = std::move(other.filePath);
+        mapping = std::exchange(other.mapping, nullptr);
+        mappingSize = std::exchange(other.mappingSize, 0);
+    }
+    return *this;
+}
+
+std::span<const TraceRecord> TraceSegment::records() const {
+    // Pairs with the writer's release store after it copies the records in
+    uint64_t count = std::atomic_ref<const uint64_t>(header().recordCount).load(std::memory_order_acquire);
+    std::size_t mapped = (mappingSize - sizeof(TraceSegmentHeader)) / sizeof(TraceRecord);
+    count = std::min<uint64_t>(count, mapped);
+    return { reinterpret_cast<const TraceRecord*>(mapping + sizeof(TraceSegmentHeader)), static_cast<std::size_t>(count) };
+}
+
+TraceReader::TraceReader(const std::string& directory, const std::string& prefix) {
+    // Keyed by the zero-padded index, so key order is recording order
+    std::map<std::string, std::pair<std::string, bool>> found;
+    std::string stem = prefix + "-";
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() < stem.size() + 6 || name.compare(0, stem.size(), stem) != 0) {
+            continue;
+        }
+        std::string suffix = name.substr(stem.size() + 6);
+        if (suffix != ".trace" && suffix != ".ctrace") {
+            continue;
+        }
+        bool compact = suffix == ".ctrace";
+        auto [it, added] = found.try_emplace(name.substr(stem.size(), 6), entry.path().string(), compact);
+        if (!added && compact) {
+            // Caught between compaction and removing the raw file
+            it->second = { entry.path().string(), true };
+        }
+    }
+    if (found.empty()) {
+        throw std::runtime_error("TraceReader: no " + stem + "NNNNNN.trace or .ctrace segments in " + directory);
+    }
+    for (const auto& [index, file] : found) {
+        if (file.second) {
+            parts.push_back({ true, compactTraces.size() });
+            compactTraces.emplace_back(file.first);
+        } else {
+            parts.push_back({ false, traceSegments.size() });
+            traceSegments.emplace_back(file.first);
+        }
+    }
+}
+
+uint64_t TraceReader::recordCount() const {
+    uint64_t total = 0;
+    for (const TraceSegment& segment : traceSegments) {
+        total += segment.records().size();
+    }
+    for (const CompactTrace& trace : compactTraces) {
+        total += trace.recordCount();
+    }
+    return total;
+}
+
+uint32_t TraceReader::lastTick() const {
+    uint32_t tick = 0;
+    for (const TraceSegment& segment : traceSegments) {
+        tick = std::max(tick, segment.header().lastTick);
+    }
+    for (const CompactTrace& trace : compactTraces) {
+        tick = std::max(tick, trace.header().lastTick);
+    }
+    return tick;
+}
+
+#endif // __linux__
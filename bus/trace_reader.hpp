@@ -0,0 +1,92 @@
+// trace_reader.hpp
+#pragma once
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "trace_compact.hpp"
+#include "trace_format.hpp"
+
+// One trace segment mapped read-only. records() points straight into the
+// mapping; nothing is copied. A segment still being written can be read
+// while it grows: records() reflects the writer's count each time it is
+// called.
+class TraceSegment {
+public:
+    // Throws std::runtime_error if the file is missing or not a trace
+    explicit TraceSegment(const std::string& path);
+    ~TraceSegment();
+
+    TraceSegment(TraceSegment&& other) noexcept;
+    TraceSegment& operator=(TraceSegment&& other) noexcept;
+    TraceSegment(const TraceSegment&) = delete;
+    TraceSegment& operator=(const TraceSegment&) = delete;
+
+    const TraceSegmentHeader& header() const { return *reinterpret_cast<const TraceSegmentHeader*>(mapping); }
+    std::span<const TraceRecord> records() const;
+    const std::string& path() const { return filePath; }
+
+private:
+    std::string filePath;
+    const uint8_t* mapping = nullptr;
+    std::size_t mappingSize = 0;
+};
+
+// Every segment of a recorded trace, <directory>/<prefix>-NNNNNN.trace or
+// .ctrace (compacted), in recording order. Where a segment exists in both
+// forms the compact one is read.
+class TraceReader {
+public:
+    // Throws std::runtime_error if no segment is found
+    TraceReader(const std::string& directory, const std::string& prefix = "bus");
+
+    const std::vector<TraceSegment>& segments() const { return traceSegments; }
+    const std::vector<CompactTrace>& compactSegments() const { return compactTraces; }
+
+    // Visit records in order, as const TraceRecord&, until f returns false.
+    // Records of a raw segment point into its mapping; those of a compact
+    // one are decoded a block at a time and are only valid during the call.
+    template <typename F>
+    void forEach(F&& f) const {
+        bool more = true;
+        auto visit = [&f, &more](const TraceRecord& record) {
+            more = f(record);
+            return more;
+        };
+        for (const Part& part : parts) {
+            if (part.compact) {
+                // A corrupt block ends that segment; the rest are still read
+                compactTraces[part.index].forEach(visit);
+            } else {
+                for (const TraceRecord& record : traceSegments[part.index].records()) {
+                    if (!visit(record)) {
+                        break;
+                    }
+                }
+            }
+            if (!more) {
+                return;
+            }
+        }
+    }
+
+    uint64_t recordCount() const;
+
+    // The run's final tick, from TraceRecorder::close(); 0 if the recorder
+    // never closed or did not know it
+    uint32_t lastTick() const;
+
+private:
+    struct Part {
+        bool compact;
+        std::size_t index;      // Into traceSegments or compactTraces
+    };
+
+    std::vector<TraceSegment> traceSegments;
+    std::vector<CompactTrace> compactTraces;
+    std::vector<Part> parts;    // Recording order
+};
+
+#endif // __linux__
@@ -0,0 +1,277 @@
+// trace_recorder.cpp
+#ifdef __linux__
+#include "trace_recorder.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "trace_compact.hpp"
+#include "trace_reader.hpp"
+
+TraceRecorder::TraceRecorder(Options options)
+    : options(std::move(options)), ring(this->options.ringCapacity) {
+    if (this->options.segmentRecords == 0) {
+        throw std::runtime_error("TraceRecorder: segmentRecords must be positive");
+    }
+    // Each run gets a directory of its own, so an earlier recording (say, of
+    // the crash being investigated) is never overwritten
+    std::error_code error;
+    std::filesystem::create_directories(this->options.directory, error);
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+    std::string base = this->options.directory + "/" + this->options.prefix + "-" + stamp;
+    runPath = base;
+    for (int attempt = 1; !std::filesystem::create_directory(runPath, error); ++attempt) {
+        if (error || attempt == 100) {
+            throw std::runtime_error("TraceRecorder: cannot create a run directory under " + this->options.directory);
+        }
+        runPath = base + "-" + std::to_string(attempt);
+    }
+    openSegment();
+    if (!mapping) {
+        throw std::runtime_error("TraceRecorder: cannot create a segment in " + runPath);
+    }
+    std::cout << "[TraceRecorder] Recording to " << runPath << std::endl;
+    if (this->options.compact) {
+        compactor = std::thread([this] { compactLoop(); });
+    }
+    writer = std::thread([this] { writeLoop(); });
+}
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+void TraceRecorder::onMessage(const Message& msg, TapPoint point, uint32_t tick) {
+    TraceRecord record{};
+    record.timestampNs = busClockNs();
+    record.tick = tick;
+    record.point = point;
+    record.msg = msg;
+    if (!running.load(std::memory_order_relaxed) || !ring.tryPush(record)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TraceRecorder::close(uint32_t lastTick) {
+    // Read by the writer once it sees running cleared
+    finalTick = lastTick;
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    std::cout << "[TraceRecorder] Recorded " << recorded() << " messages in " << segments() << " segments, "
+              << dropped() << " dropped" << std::endl;
+
+    // The writer has queued the last segment; let the compactor finish it
+    if (compactor.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(compactMutex);
+            compactStopping = true;
+        }
+        compactReady.notify_one();
+        compactor.join();
+        std::cout << "[TraceRecorder] Compacted " << compacted() << " segments, " << rawBytes << " -> "
+                  << compactBytes << " bytes" << std::endl;
+    }
+}
+
+void TraceRecorder::writeLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        if (!drain()) {
+            std::this_thread::sleep_for(options.pollInterval);
+        }
+    }
+    // Everything pushed before close() is in the ring now
+    while (drain()) {
+    }
+    if (header) {
+        header->lastTick = finalTick;
+    }
+    closeSegment();
+}
+
+bool TraceRecorder::drain() {
+    if (!mapping && std::chrono::steady_clock::now() >= retryOpenAt) {
+        nextSegment();
+    }
+    std::size_t count = 0;
+    while (count < WRITE_BATCH) {
+        if (mapping && used == options.segmentRecords) {
+            closeSegment();
+            nextSegment();
+        }
+        if (!mapping) {
+            // No segment to write to; keep the ring moving
+            TraceRecord discard;
+            if (!ring.tryPop(discard)) {
+                break;
+            }
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            ++count;
+            continue;
+        }
+        // Pop straight into the mapped file
+        if (!ring.tryPop(records[used])) {
+            break;
+        }
+        ++used;
+        ++count;
+    }
+    if (count > 0 && mapping) {
+        publishCount();
+    }
+    return count > 0;
+}
+
+void TraceRecorder::nextSegment() {
+    openSegment();
+    if (mapping) {
+        openBackoff = OPEN_RETRY_MIN;
+        return;
+    }
+    // Most likely the disk is full; drop records for a while instead of
+    // retrying for every one
+    retryOpenAt = std::chrono::steady_clock::now() + openBackoff;
+    openBackoff = std::min(openBackoff * 2, OPEN_RETRY_MAX);
+}
+
+void TraceRecorder::publishCount() {
+    if (used == 0) {
+        return;
+    }
+    // Live readers poll recordCount; the records it covers are written first
+    header->firstNs = records[0].timestampNs;
+    header->lastNs = records[used - 1].timestampNs;
+    std::atomic_ref<uint64_t>(header->recordCount).store(used, std::memory_order_release);
+    written.store(written.load(std::memory_order_relaxed) + (used - published), std::memory_order_relaxed);
+    published = used;
+}
+
+void TraceRecorder::openSegment() {
+    uint32_t index = segmentCount.load(std::memory_order_relaxed);
+    char name[32];
+    std::snprintf(name, sizeof(name), "-%06u.trace", index);
+    std::string path = runPath + "/" + options.prefix + name;
+
+    // Readers only look at *.trace, so build the segment under another name
+    // and rename it once the header is valid
+    std::string building = path + ".tmp";
+    int fd = open(building.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[TraceRecorder] Cannot create " << building << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    std::size_t size = sizeof(TraceSegmentHeader) + options.segmentRecords * sizeof(TraceRecord);
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(size));
+    void* base = err == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (base == MAP_FAILED) {
+        std::cerr << "[TraceRecorder] Cannot map " << path << ": " << std::strerror(err ? err : errno) << std::endl;
+        ::close(fd);
+        unlink(building.c_str());
+        return;
+    }
+    madvise(base, size, MADV_SEQUENTIAL);
+
+    segmentFd = fd;
+    segmentPath = path;
+    mapping = static_cast<uint8_t*>(base);
+    mappingSize = size;
+    header = reinterpret_cast<TraceSegmentHeader*>(mapping);
+    records = reinterpret_cast<TraceRecord*>(mapping + sizeof(TraceSegmentHeader));
+    used = 0;
+    published = 0;
+
+    std::memcpy(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header->version = TRACE_VERSION;
+    header->recordSize = sizeof(TraceRecord);
+    header->headerSize = sizeof(TraceSegmentHeader);
+    header->segmentIndex = index;
+    header->capacity = options.segmentRecords;
+    if (rename(building.c_str(), path.c_str()) != 0) {
+        std::cerr << "[TraceRecorder] Cannot rename " << building << ": " << std::strerror(errno) << std::endl;
+    }
+    segmentCount.store(index + 1, std::memory_order_relaxed);
+}
+
+void TraceRecorder::closeSegment() {
+    if (!mapping) {
+        return;
+    }
+    publishCount();
+    msync(mapping, mappingSize, MS_ASYNC);
+    munmap(mapping, mappingSize);
+
+    // Give back the unused tail of a segment closed early
+    if (used < options.segmentRecords) {
+        if (ftruncate(segmentFd, static_cast<off_t>(sizeof(TraceSegmentHeader) + used * sizeof(TraceRecord))) != 0) {
+            std::cerr << "[TraceRecorder] Cannot trim segment: " << std::strerror(errno) << std::endl;
+        }
+    }
+    ::close(segmentFd);
+    segmentFd = -1;
+    mapping = nullptr;
+    header = nullptr;
+    records = nullptr;
+
+    if (options.compact) {
+        {
+            std::lock_guard<std::mutex> lock(compactMutex);
+            compactQueue.push_back(std::move(segmentPath));
+        }
+        compactReady.notify_one();
+    }
+}
+
+void TraceRecorder::compactLoop() {
+    std::unique_lock<std::mutex> lock(compactMutex);
+    for (;;) {
+        compactReady.wait(lock, [this] { return !compactQueue.empty() || compactStopping; });
+        if (compactQueue.empty()) {
+            return;
+        }
+        std::string path = std::move(compactQueue.front());
+        compactQueue.pop_front();
+        lock.unlock();
+        compactSegment(path);
+        lock.lock();
+    }
+}
+
+void TraceRecorder::compactSegment(const std::string& path) {
+    // <prefix>-NNNNNN.trace becomes <prefix>-NNNNNN.ctrace
+    std::string compactPath = path.substr(0, path.size() - std::strlen(".trace")) + ".ctrace";
+    try {
+        TraceSegment segment(path);
+        CompactTraceWriter compact(compactPath, segment.header().segmentIndex, segment.header().lastTick);
+        for (const TraceRecord& record : segment.records()) {
+            compact.append(record);
+        }
+        if (!compact.close()) {
+            // The raw segment stays; readers fall back to it
+            return;
+        }
+        rawBytes += sizeof(TraceSegmentHeader) + segment.records().size() * sizeof(TraceRecord);
+        compactBytes += compact.bytes();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "[TraceRecorder] Cannot compact " << path << ": " << e.what() << std::endl;
+        return;
+    }
+    unlink(path.c_str());
+    compactedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif // __linux__
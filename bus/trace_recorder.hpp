@@ -0,0 +1,115 @@
+// trace_recorder.hpp
+#pragma once
+#ifdef __linux__
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "message_bus.hpp"
+#include "spsc_ring.hpp"
+#include "trace_format.hpp"
+
+// Records every message crossing the tick boundary into a rolling set of
+// memory-mapped segment files, <run>/<prefix>-NNNNNN.trace. Each recorder
+// creates its own run directory, <directory>/<prefix>-YYYYMMDD-HHMMSS, and
+// never deletes earlier ones; replay reads one run directory. Install it
+// with MessageBus::setTap().
+//
+// The tap only stamps the message and pushes it onto an SPSC ring; a
+// background thread copies records into the mapped segment, preallocated
+// when opened, and maps the next one when it fills. The tick thread never
+// touches the disk or waits on the writer: if the ring is full the record
+// is dropped and counted. So are records that arrive while no segment can
+// be opened; the writer retries with a growing delay.
+//
+// With Options::compact, each segment is re-encoded once sealed as
+// <prefix>-NNNNNN.ctrace (trace_compact.hpp) and the raw file removed. That
+// happens on a third thread, so the writer keeps draining the ring while a
+// segment is compacted; TraceReader reads either kind.
+class TraceRecorder : public BusTap {
+public:
+    struct Options {
+        std::string directory = ".";
+        std::string prefix = "bus";
+        std::size_t segmentRecords = 1 << 20;   // 48 MB per segment
+        std::size_t ringCapacity = 1 << 16;
+        std::chrono::microseconds pollInterval{1000};
+        bool compact = false;
+    };
+
+    // Throws std::runtime_error if the first segment cannot be created
+    explicit TraceRecorder(Options options);
+    ~TraceRecorder() override;
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Tick thread
+    void onMessage(const Message& msg, TapPoint point, uint32_t tick) override;
+
+    // Drain the ring, finish the current segment and stop the writer. Later
+    // records are dropped. The destructor calls it. lastTick, the run's
+    // final tick, goes in the last segment's header, so a replay steps the
+    // quiet ticks after the last recorded message too.
+    void close(uint32_t lastTick = 0);
+
+    uint64_t recorded() const { return written.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint32_t segments() const { return segmentCount.load(std::memory_order_relaxed); }
+    uint32_t compacted() const { return compactedCount.load(std::memory_order_relaxed); }
+    const std::string& runDirectory() const { return runPath; }
+
+private:
+    static constexpr std::size_t WRITE_BATCH = 256;
+    static constexpr std::chrono::milliseconds OPEN_RETRY_MIN{100};
+    static constexpr std::chrono::milliseconds OPEN_RETRY_MAX{10000};
+
+    void writeLoop();
+    bool drain();
+    void openSegment();
+    void nextSegment();
+    void closeSegment();
+    void publishCount();
+    void compactLoop();
+    void compactSegment(const std::string& path);
+
+    Options options;
+    std::string runPath;
+    SpscRing<TraceRecord> ring;
+    std::thread writer;
+    std::atomic<bool> running{true};
+    uint32_t finalTick = 0;         // Set by close() before it stops the writer
+
+    // Writer thread only
+    int segmentFd = -1;
+    uint8_t* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    std::string segmentPath;
+    TraceSegmentHeader* header = nullptr;
+    TraceRecord* records = nullptr;
+    std::size_t used = 0;           // Records in the current segment
+    std::size_t published = 0;      // Of those, counted in written
+    std::chrono::steady_clock::time_point retryOpenAt;
+    std::chrono::milliseconds openBackoff = OPEN_RETRY_MIN;
+
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<uint32_t> segmentCount{0};
+
+    // Sealed segments waiting for the compactor
+    std::thread compactor;
+    std::mutex compactMutex;
+    std::condition_variable compactReady;
+    std::deque<std::string> compactQueue;
+    bool compactStopping = false;
+    std::atomic<uint32_t> compactedCount{0};
+    uint64_t rawBytes = 0;          // Compactor thread only until it is joined
+    uint64_t compactBytes = 0;
+};
+
+#endif // __linux__
@@ -0,0 +1,72 @@
+// type_batches.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <vector>
+#include "message_registry.hpp"
+#include "message_types.hpp"
+
+namespace detail {
+    template <typename List>
+    struct BatchStorage;
+
+    template <typename... Ts>
+    struct BatchStorage<PayloadList<Ts...>> {
+        using type = std::tuple<std::vector<Ts>...>;
+    };
+} // namespace detail
+
+// One tick's inbound messages partitioned by payload type into contiguous
+// per-type arrays (a stable counting sort), so consumers can process a whole
+// run of ButtonPress, then a run of AnalogSample, and so on. Arrival order
+// within each type is preserved. Storage is reserved once up front.
+class TypeBatches {
+public:
+    explicit TypeBatches(std::size_t capacity) {
+        std::apply([capacity](auto&... batch) { (batch.reserve(capacity), ...); }, batches);
+    }
+
+    // Partition messages, visited in arrival order by forEach(fn)
+    template <typename ForEach>
+    void partition(ForEach&& forEach) {
+        // Counting pass: size each typed array exactly
+        std::array<std::size_t, MESSAGE_TYPE_COUNT> counts{};
+        forEach([&counts](const Message& msg) {
+            ++counts[static_cast<std::size_t>(msg.type)];
+        });
+        std::apply([&counts](auto&... batch) {
+            (batch.resize(counts[payloadIdOf(batch)]), ...);
+        }, batches);
+
+        // Scatter pass: copy each payload to the next slot for its type
+        std::array<std::size_t, MESSAGE_TYPE_COUNT> cursors{};
+        auto scatter = makeDispatcher([&](const auto& payload) {
+            using T = std::decay_t<decltype(payload)>;
+            std::get<std::vector<T>>(batches)[cursors[payloadId<T>]++] = payload;
+        });
+        forEach(scatter);
+    }
+
+    template <typename T>
+    std::span<const T> get() const {
+        return std::get<std::vector<T>>(batches);
+    }
+
+    // Call fn(std::span<const T>) once per registered payload type
+    template <typename Fn>
+    void forEachBatch(Fn&& fn) const {
+        std::apply([&fn](const auto&... batch) {
+            (fn(std::span(std::as_const(batch))), ...);
+        }, batches);
+    }
+
+private:
+    template <typename T>
+    static constexpr std::size_t payloadIdOf(const std::vector<T>&) {
+        return payloadId<T>;
+    }
+
+    detail::BatchStorage<RegisteredPayloads>::type batches;
+};
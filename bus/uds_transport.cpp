@@ -0,0 +1,364 @@
+// uds_transport.cpp
+#ifdef __linux__
+#include "uds_transport.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    // Abstract-namespace address: leading NUL, then the name
+    socklen_t makeAddress(const std::string& endpointName, sockaddr_un& addr) {
+        std::string path = "fidget_reactor/" + endpointName;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::size_t length = std::min(path.size(), sizeof(addr.sun_path) - 1);
+        std::memcpy(addr.sun_path + 1, path.data(), length);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + length);
+    }
+
+    bool isDisconnect(int err) {
+        return err == EPIPE || err == ECONNRESET || err == ENOTCONN || err == ECONNREFUSED;
+    }
+
+    // Each packet holds exactly one Message; n is the packet's full length.
+    // Binary frames are viewed in place; other formats are decoded into scratch.
+    bool viewPacket(BusCodec& codec, const uint8_t* packet, ssize_t n, Message& scratch, MessageView& view) {
+        if (n > static_cast<ssize_t>(BusCodec::MAX_PACKET_SIZE)) {
+            std::cerr << "[UdsTransport] Dropped oversized packet of " << n << " bytes" << std::endl;
+            return false;
+        }
+        std::span<const uint8_t> bytes{ packet, static_cast<std::size_t>(n) };
+        if (codec.format() == WireFormat::BINARY) {
+            WireStatus status = MessageView::parse(bytes, view);
+            if (status != WireStatus::OK) {
+                std::cerr << "[UdsTransport] Dropped malformed frame (" << wireStatusName(status) << ")" << std::endl;
+                return false;
+            }
+            return true;
+        }
+        if (!codec.decode(bytes, scratch)) {
+            std::cerr << "[UdsTransport] Dropped malformed " << wireFormatName(codec.format()) << " packet" << std::endl;
+            return false;
+        }
+        view = MessageView(scratch);
+        return true;
+    }
+
+    // Copy views out until one materializes
+    bool receiveCopy(BusTransport& transport, Message& msg) {
+        MessageView view;
+        while (transport.receiveView(view)) {
+            if (view.materialize(msg)) {
+                return true;
+            }
+            std::cerr << "[UdsTransport] Dropped frame with malformed body" << std::endl;
+        }
+        return false;
+    }
+
+} // namespace
+
+UdsClientTransport::UdsClientTransport(const std::string& endpointName, std::unique_ptr<BusCodec> codec)
+    : endpointName(endpointName), codec(codec ? std::move(codec) : std::make_unique<BinaryCodec>()) {
+    ensureConnected();
+}
+
+UdsClientTransport::~UdsClientTransport() {
+    disconnect();
+}
+
+bool UdsClientTransport::ensureConnected() {
+    if (fd >= 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastAttempt < RECONNECT_INTERVAL) {
+        return false;
+    }
+    lastAttempt = now;
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "[UdsClientTransport] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    sockaddr_un addr;
+    socklen_t length = makeAddress(endpointName, addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), length) != 0) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    ++generation;
+    std::cout << "[UdsClientTransport] Connected to " << endpointName << std::endl;
+    return true;
+}
+
+void UdsClientTransport::disconnect() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool UdsClientTransport::send(const Message& msg) {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (!ensureConnected()) {
+        return false;
+    }
+
+    uint8_t packet[BusCodec::MAX_PACKET_SIZE];
+    std::size_t size = codec->encode(msg, packet);
+    if (size == 0) {
+        return false;
+    }
+    ssize_t n = ::send(fd, packet, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n == static_cast<ssize_t>(size)) {
+        return true;
+    }
+    if (n < 0 && isDisconnect(errno)) {
+        std::cerr << "[UdsClientTransport] Lost connection to " << endpointName << std::endl;
+        disconnect();
+    }
+    return false;
+}
+
+std::size_t UdsClientTransport::sendBatch(std::span<const Message> msgs) {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (!ensureConnected()) {
+        return 0;
+    }
+
+    uint8_t packets[SEND_BATCH][BusCodec::MAX_PACKET_SIZE];
+    iovec iovs[SEND_BATCH];
+    mmsghdr headers[SEND_BATCH];
+    std::size_t sent = 0;
+    while (sent < msgs.size()) {
+        std::size_t count = 0;
+        while (count < SEND_BATCH && sent + count < msgs.size()) {
+            std::size_t size = codec->encode(msgs[sent + count], packets[count]);
+            if (size == 0) {
+                break;
+            }
+            iovs[count] = { packets[count], size };
+            headers[count] = {};
+            headers[count].msg_hdr.msg_iov = &iovs[count];
+            headers[count].msg_hdr.msg_iovlen = 1;
+            ++count;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        int n = sendmmsg(fd, headers, static_cast<unsigned>(count), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (isDisconnect(errno)) {
+                std::cerr << "[UdsClientTransport] Lost connection to " << endpointName << std::endl;
+                disconnect();
+            }
+            break;
+        }
+        sent += static_cast<std::size_t>(n);
+        if (static_cast<std::size_t>(n) < count) {
+            break;
+        }
+    }
+    return sent;
+}
+
+bool UdsClientTransport::receive(Message& msg) {
+    return receiveCopy(*this, msg);
+}
+
+bool UdsClientTransport::receiveView(MessageView& view) {
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (!ensureConnected()) {
+        return false;
+    }
+
+    ssize_t n;
+    while ((n = recv(fd, rxPacket, sizeof(rxPacket), MSG_DONTWAIT | MSG_TRUNC)) > 0) {
+        if (viewPacket(*codec, rxPacket, n, viewScratch, view)) {
+            return true;
+        }
+    }
+    codec->endBatch();
+    if (n == 0 || (n < 0 && isDisconnect(errno))) {
+        std::cerr << "[UdsClientTransport] Peer closed " << endpointName << std::endl;
+        disconnect();
+    }
+    return false;
+}
+
+bool UdsClientTransport::waitReadable(int timeoutMs) {
+    int current;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        ensureConnected();
+        current = fd;
+    }
+    if (current < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+
+    pollfd pfd{ current, POLLIN, 0 };
+    return poll(&pfd, 1, timeoutMs) > 0;
+}
+
+UdsServerTransport::UdsServerTransport(const std::string& endpointName, std::unique_ptr<BusCodec> codec)
+    : endpointName(endpointName), codec(codec ? std::move(codec) : std::make_unique<BinaryCodec>()) {
+    listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("UdsServerTransport: socket() failed: " + std::string(std::strerror(errno)));
+    }
+
+    sockaddr_un addr;
+    socklen_t length = makeAddress(endpointName, addr);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), length) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+        int err = errno;
+        close(listenFd);
+        throw std::runtime_error("UdsServerTransport: cannot listen on " + endpointName + ": " + std::strerror(err));
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    std::cout << "[UdsServerTransport] Listening on " << endpointName << std::endl;
+}
+
+UdsServerTransport::~UdsServerTransport() {
+    std::lock_guard<std::mutex> lock(peersMutex);
+    for (int peer : peers) {
+        close(peer);
+    }
+    close(epollFd);
+    close(listenFd);
+}
+
+std::size_t UdsServerTransport::peerCount() const {
+    std::lock_guard<std::mutex> lock(peersMutex);
+    return peers.size();
+}
+
+void UdsServerTransport::acceptPeers() {
+    int peer;
+    while ((peer = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = peer;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, peer, &ev);
+
+        std::lock_guard<std::mutex> lock(peersMutex);
+        peers.push_back(peer);
+        std::cout << "[UdsServerTransport] Peer connected on " << endpointName << std::endl;
+    }
+}
+
+void UdsServerTransport::dropPeer(int peer) {
+    // Forget the descriptor before closing it, so a concurrent send() never
+    // writes to the number after it has been reused
+    {
+        std::lock_guard<std::mutex> lock(peersMutex);
+        peers.erase(std::remove(peers.begin(), peers.end(), peer), peers.end());
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, peer, nullptr);
+    close(peer);
+    if (lastSender == peer) {
+        lastSender = -1;
+    }
+    std::cout << "[UdsServerTransport] Peer disconnected from " << endpointName << std::endl;
+}
+
+bool UdsServerTransport::send(const Message& msg) {
+    return broadcast(msg, -1);
+}
+
+bool UdsServerTransport::relay(const Message& msg) {
+    return broadcast(msg, lastSender);
+}
+
+bool UdsServerTransport::broadcast(const Message& msg, int skip) {
+    std::lock_guard<std::mutex> lock(peersMutex);
+
+    // Encode once for every peer
+    uint8_t packet[BusCodec::MAX_PACKET_SIZE];
+    std::size_t size = codec->encode(msg, packet);
+    if (size == 0) {
+        return false;
+    }
+
+    bool delivered = false;
+    for (int peer : peers) {
+        if (peer != skip && ::send(peer, packet, size, MSG_DONTWAIT | MSG_NOSIGNAL) == static_cast<ssize_t>(size)) {
+            delivered = true;
+        }
+    }
+    return delivered;
+}
+
+bool UdsServerTransport::receive(Message& msg) {
+    return receiveCopy(*this, msg);
+}
+
+bool UdsServerTransport::receiveView(MessageView& view) {
+    for (int pass = 0; pass < 2; ++pass) {
+        if (readyCursor >= readyCount) {
+            readyCount = epoll_wait(epollFd, ready, MAX_EVENTS, 0);
+            readyCursor = 0;
+            if (readyCount <= 0) {
+                readyCount = 0;
+                codec->endBatch();
+                return false;
+            }
+        }
+
+        while (readyCursor < readyCount) {
+            int fd = ready[readyCursor].data.fd;
+            if (fd == listenFd) {
+                acceptPeers();
+                ++readyCursor;
+                continue;
+            }
+
+            ssize_t n = recv(fd, rxPacket, sizeof(rxPacket), MSG_DONTWAIT | MSG_TRUNC);
+            if (n > 0) {
+                if (viewPacket(*codec, rxPacket, n, viewScratch, view)) {
+                    lastSender = fd;
+                    return true; // Stay on this peer; it may have more queued
+                }
+                continue;
+            }
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                dropPeer(fd);
+            }
+            ++readyCursor;
+        }
+    }
+    codec->endBatch();
+    return false;
+}
+
+bool UdsServerTransport::waitReadable(int timeoutMs) {
+    if (readyCursor < readyCount) {
+        return true;
+    }
+    pollfd pfd{ epollFd, POLLIN, 0 };
+    return poll(&pfd, 1, timeoutMs) > 0;
+}
+
+#endif // __linux__
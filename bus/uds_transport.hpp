@@ -0,0 +1,96 @@
+// uds_transport.hpp
+#pragma once
+#ifdef __linux__
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/epoll.h>
+#include "bus_codec.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// Unix domain SOCK_SEQPACKET transports. Like PIPE_TYPE_MESSAGE pipes, every
+// send arrives as exactly one packet, carrying one Message encoded by the
+// transport's BusCodec (binary wire frames unless told otherwise). Both ends
+// of a link must use the same codec. Endpoints live in the abstract socket
+// namespace as fidget_reactor/<pipe name>, so nothing is left on disk.
+
+// Connects to a named endpoint; reconnects lazily after the peer goes away.
+// send() and receive() may be called from different threads.
+class UdsClientTransport : public BusTransport {
+public:
+    explicit UdsClientTransport(const std::string& endpointName, std::unique_ptr<BusCodec> codec = nullptr);
+    ~UdsClientTransport() override;
+
+    bool send(const Message& msg) override;
+    std::size_t sendBatch(std::span<const Message> msgs) override;
+    bool receive(Message& msg) override;
+    bool receiveView(MessageView& view) override;
+    bool waitReadable(int timeoutMs) override;
+    int pollFd() const override { return fd; }
+    uint32_t connectionGeneration() const override { return generation; }
+    BusCodec* packetCodec() override { return codec.get(); }
+
+    bool connected() const { return fd >= 0; }
+
+private:
+    static constexpr std::chrono::milliseconds RECONNECT_INTERVAL{500};
+    static constexpr std::size_t SEND_BATCH = 64;     // Packets per sendmmsg
+
+    // Callers hold connectionMutex
+    bool ensureConnected();
+    void disconnect();
+
+    std::string endpointName;
+    std::unique_ptr<BusCodec> codec;
+    std::mutex connectionMutex;
+    int fd = -1;
+    uint32_t generation = 0;
+    uint8_t rxPacket[BusCodec::MAX_PACKET_SIZE] = {};   // Backs receiveView()
+    std::chrono::steady_clock::time_point lastAttempt{};
+};
+
+// Listens on a named endpoint and accepts any number of peers. Receives from
+// whichever peer is ready; sends go to every connected peer, like a shared pipe.
+class UdsServerTransport : public BusTransport {
+public:
+    explicit UdsServerTransport(const std::string& endpointName, std::unique_ptr<BusCodec> codec = nullptr);
+    ~UdsServerTransport() override;
+
+    bool send(const Message& msg) override;
+    bool receive(Message& msg) override;
+    bool receiveView(MessageView& view) override;
+    bool waitReadable(int timeoutMs) override;
+    int pollFd() const override { return epollFd; }
+
+    // Like send(), but skips the peer the last received message came from,
+    // so a host can pass traffic between peers without echoing it back.
+    // Call from the receiving thread.
+    bool relay(const Message& msg);
+
+    std::size_t peerCount() const;
+
+private:
+    static constexpr int MAX_EVENTS = 32;
+
+    void acceptPeers();
+    void dropPeer(int peer);
+    bool broadcast(const Message& msg, int skip);
+
+    std::string endpointName;
+    std::unique_ptr<BusCodec> codec;
+    int listenFd = -1;
+    int epollFd = -1;
+    std::vector<int> peers;
+    mutable std::mutex peersMutex;
+    epoll_event ready[MAX_EVENTS] = {};
+    int readyCount = 0;
+    int readyCursor = 0;
+    int lastSender = -1;            // Peer of the last received message
+    uint8_t rxPacket[BusCodec::MAX_PACKET_SIZE] = {};   // Backs receiveView()
+};
+
+#endif // __linux__
@@ -0,0 +1,634 @@
+// uring_event_loop.cpp
+#include "uring_event_loop.hpp"
+#ifdef FIDGET_HAVE_IO_URING
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+    int uringSetup(unsigned entries, io_uring_params& params) {
+        return static_cast<int>(syscall(SYS_io_uring_setup, entries, &params));
+    }
+
+    int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, std::size_t argSize) {
+        return static_cast<int>(syscall(SYS_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    int uringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+        return static_cast<int>(syscall(SYS_io_uring_register, fd, opcode, arg, count));
+    }
+
+    // Ring indices are shared with the kernel
+    unsigned loadAcquire(unsigned* p) {
+        return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(unsigned* p, unsigned value) {
+        std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+    }
+
+    std::runtime_error uringError(const std::string& what) {
+        return std::runtime_error("UringEventLoop: " + what + ": " + std::strerror(errno));
+    }
+
+} // namespace
+
+UringEventLoop::UringEventLoop() {
+    try {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+        params.cq_entries = SQ_ENTRIES * 8;   // Multishot recv can post many CQEs per SQE
+        ringFd = uringSetup(SQ_ENTRIES, params);
+        if (ringFd < 0 && errno == EINVAL) {
+            // COOP_TASKRUN needs 5.19
+            params = io_uring_params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = SQ_ENTRIES * 8;
+            ringFd = uringSetup(SQ_ENTRIES, params);
+        }
+        if (ringFd < 0) {
+            throw uringError("io_uring_setup failed");
+        }
+
+        constexpr unsigned REQUIRED = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+        if ((params.features & REQUIRED) != REQUIRED) {
+            errno = ENOTSUP;
+            throw uringError("kernel lacks required io_uring features");
+        }
+
+        // SQ and CQ rings share one mapping (IORING_FEAT_SINGLE_MMAP)
+        std::size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        std::size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqMappingSize = std::max(sqSize, cqSize);
+        sqMapping = mmap(nullptr, sqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqMapping == MAP_FAILED) {
+            sqMapping = nullptr;
+            throw uringError("mmap of rings failed");
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqeMapping = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqeMapping == MAP_FAILED) {
+            throw uringError("mmap of SQEs failed");
+        }
+        sqes = static_cast<io_uring_sqe*>(sqeMapping);
+
+        char* base = static_cast<char*>(sqMapping);
+        sqHead = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+        sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+        sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        sqLocalTail = *sqTail;
+        cqHead = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+
+        // Receive buffers are handed to the kernel through a registered
+        // buffer ring; each completion names the buffer it filled
+        bufRingSize = RECV_BUFFERS * sizeof(io_uring_buf);
+        void* ringMemory = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ringMemory == MAP_FAILED) {
+            throw uringError("mmap of buffer ring failed");
+        }
+        bufRing = static_cast<io_uring_buf_ring*>(ringMemory);
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+        reg.ring_entries = RECV_BUFFERS;
+        reg.bgid = BUFFER_GROUP;
+        if (uringRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            throw uringError("registering the buffer ring failed");
+        }
+
+        recvBuffers = std::make_unique<FrameSlot[]>(RECV_BUFFERS);
+        for (unsigned bid = 0; bid < RECV_BUFFERS; ++bid) {
+            recycleBuffer(static_cast<uint16_t>(bid));
+        }
+
+        sendSlots = std::make_unique<FrameSlot[]>(SEND_SLOTS);
+        slotOwners.assign(SEND_SLOTS, nullptr);
+        freeSendSlots.reserve(SEND_SLOTS);
+        for (unsigned slot = SEND_SLOTS; slot > 0; --slot) {
+            freeSendSlots.push_back(static_cast<uint16_t>(slot - 1));
+        }
+
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            throw uringError("eventfd failed");
+        }
+        addFd(wakeFd, [this] {
+            uint64_t value;
+            while (read(wakeFd, &value, sizeof(value)) > 0) {}
+        });
+    } catch (...) {
+        teardown();
+        throw;
+    }
+
+    std::cout << "[UringEventLoop] Ring ready (" << sqEntries << " SQEs, " << RECV_BUFFERS << " receive buffers)" << std::endl;
+}
+
+UringEventLoop::~UringEventLoop() {
+    teardown();
+}
+
+void UringEventLoop::teardown() {
+    // Closing the ring cancels everything still in flight
+    if (ringFd >= 0) {
+        close(ringFd);
+        ringFd = -1;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    if (bufRing) {
+        munmap(bufRing, bufRingSize);
+        bufRing = nullptr;
+    }
+    if (sqes) {
+        munmap(sqes, sqesSize);
+        sqes = nullptr;
+    }
+    if (sqMapping) {
+        munmap(sqMapping, sqMappingSize);
+        sqMapping = nullptr;
+    }
+}
+
+io_uring_sqe* UringEventLoop::nextSqe() {
+    if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) {
+        // Queue full: hand the kernel what we have so far
+        enter(sqPending, 0, 0);
+    }
+    unsigned index = sqLocalTail & sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    ++sqLocalTail;
+    ++sqPending;
+    return sqe;
+}
+
+int UringEventLoop::enter(unsigned toSubmit, unsigned minComplete, int timeoutMs) {
+    storeRelease(sqTail, sqLocalTail);
+
+    unsigned flags = 0;
+    __kernel_timespec timeout{};
+    io_uring_getevents_arg arg{};
+    void* argp = nullptr;
+    std::size_t argSize = 0;
+    if (minComplete > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+        if (timeoutMs >= 0) {
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+            arg.ts = reinterpret_cast<uint64_t>(&timeout);
+            flags |= IORING_ENTER_EXT_ARG;
+            argp = &arg;
+            argSize = sizeof(arg);
+        }
+    }
+
+    int submitted = uringEnter(ringFd, toSubmit, minComplete, flags, argp, argSize);
+    ++loopStats.syscalls;
+    if (submitted < 0) {
+        if (errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+            std::cerr << "[UringEventLoop] io_uring_enter failed: " << std::strerror(errno) << std::endl;
+        }
+        return 0;
+    }
+    sqPending -= std::min(sqPending, static_cast<unsigned>(submitted));
+    if (queuedSends > 0 && sqPending == 0) {
+        countFlush(queuedSends);
+        queuedSends = 0;
+    }
+    return submitted;
+}
+
+void UringEventLoop::flush() {
+    stageSends();
+    if (sqPending > 0) {
+        enter(sqPending, 0, 0);
+    }
+}
+
+void UringEventLoop::wake() {
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        std::cerr << "[UringEventLoop] Failed to wake loop: " << std::strerror(errno) << std::endl;
+    }
+}
+
+void UringEventLoop::recycleBuffer(uint16_t bid) {
+    // Index the ring as a plain array: compiled as C++, the header's flexible
+    // bufs member lands at offset 8 instead of 0. Only addr/len/bid are
+    // written because the resv field of slot 0 overlays the ring tail.
+    io_uring_buf& buf = reinterpret_cast<io_uring_buf*>(bufRing)[bufTail & (RECV_BUFFERS - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(recvBuffers[bid].data());
+    buf.len = static_cast<uint32_t>(BusCodec::MAX_PACKET_SIZE);
+    buf.bid = bid;
+    ++bufTail;
+    std::atomic_ref<uint16_t>(bufRing->tail).store(bufTail, std::memory_order_release);
+}
+
+UringEventLoop::Entry* UringEventLoop::addEntry(Kind kind, int fd, BusTransport* transport,
+                                               ViewHandler onMessage, std::function<void()> onReady) {
+    auto entry = std::make_unique<Entry>();
+    entry->kind = kind;
+    entry->fd = fd;
+    entry->transport = transport;
+    entry->generation = transport ? transport->connectionGeneration() : 0;
+    entry->onMessage = std::move(onMessage);
+    entry->onReady = std::move(onReady);
+    Entry* raw = entry.get();
+    entries.push_back(std::move(entry));
+    return raw;
+}
+
+void UringEventLoop::arm(Entry& entry) {
+    if (entry.fd < 0 || entry.armed || entry.dead) {
+        return;
+    }
+    io_uring_sqe* sqe = nextSqe();
+    sqe->fd = entry.fd;
+    if (entry.kind == Kind::RECV) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+    } else {
+        // Oneshot poll re-armed after every completion behaves level-triggered
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll32_events = POLLIN;
+    }
+    sqe->user_data = reinterpret_cast<uint64_t>(&entry);
+    entry.armed = true;
+}
+
+void UringEventLoop::retire(Entry& entry) {
+    entry.dead = true;
+    if (!entry.armed) {
+        freeEntry(&entry);
+        return;
+    }
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = reinterpret_cast<uint64_t>(&entry);
+    sqe->user_data = TAG_IGNORE;
+}
+
+void UringEventLoop::freeEntry(Entry* entry) {
+    if (dispatching) {
+        // Its own callback may still be on the stack
+        deferredFrees.push_back(entry);
+        return;
+    }
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [entry](const std::unique_ptr<Entry>& e) { return e.get() == entry; }), entries.end());
+}
+
+bool UringEventLoop::addViewEndpoint(BusTransport& transport, ViewHandler onMessage) {
+    if (transport.pollFd() < 0) {
+        // Lazily connecting transports only connect when used; try now
+        // rather than at the first refresh
+        transport.waitReadable(0);
+    }
+    int fd = transport.pollFd();
+    Kind kind = transport.packetCodec() && multishotRecv ? Kind::RECV : Kind::POLL;
+    arm(*addEntry(kind, fd, &transport, std::move(onMessage), {}));
+    return fd >= 0;
+}
+
+void UringEventLoop::removeEndpoint(BusTransport& transport) {
+    for (auto queue = sendQueues.begin(); queue != sendQueues.end(); ++queue) {
+        if ((*queue)->transport != &transport) {
+            continue;
+        }
+        // Messages not yet staged have nowhere to go; a chain in flight
+        // still owns its send slots
+        loopStats.dropped += (*queue)->waiting.size();
+        (*queue)->waiting.clear();
+        if ((*queue)->inFlight == 0) {
+            sendQueues.erase(queue);
+        } else {
+            (*queue)->dead = true;
+        }
+        break;
+    }
+    for (auto& entry : entries) {
+        if (entry->transport == &transport && !entry->dead) {
+            retire(*entry);
+            return;
+        }
+    }
+}
+
+void UringEventLoop::addFd(int fd, std::function<void()> onReady) {
+    arm(*addEntry(Kind::WATCH, fd, nullptr, {}, std::move(onReady)));
+}
+
+void UringEventLoop::removeFd(int fd) {
+    for (auto& entry : entries) {
+        if (entry->kind == Kind::WATCH && entry->fd == fd && !entry->dead) {
+            retire(*entry);
+            return;
+        }
+    }
+}
+
+bool UringEventLoop::send(BusTransport& transport, const Message& msg) {
+    if (!transport.packetCodec() || transport.pollFd() < 0) {
+        return BusLoop::send(transport, msg);
+    }
+
+    auto it = std::find_if(sendQueues.begin(), sendQueues.end(), [&transport](const std::unique_ptr<SendQueue>& q) {
+        return q->transport == &transport && !q->dead;
+    });
+    if (it == sendQueues.end()) {
+        sendQueues.push_back(std::make_unique<SendQueue>(SendQueue{ &transport, {} }));
+        it = sendQueues.end() - 1;
+    }
+    SendQueue& queue = **it;
+    if (queue.waiting.size() >= MAX_QUEUED_SENDS) {
+        ++loopStats.dropped;
+        return false;
+    }
+    queue.waiting.push_back(msg);
+    // Behind a chain in flight, a flush could not stage these anyway
+    if (queue.inFlight == 0 && queue.waiting.size() + queuedSends >= policy.maxMessages) {
+        flush();
+    }
+    return true;
+}
+
+void UringEventLoop::stageSends() {
+    for (auto& queue : sendQueues) {
+        if (queue->inFlight == 0 && !queue->waiting.empty()) {
+            stageChain(*queue);
+        }
+    }
+}
+
+void UringEventLoop::stageChain(SendQueue& queue) {
+    int fd = queue.transport->pollFd();
+    BusCodec* codec = queue.transport->packetCodec();
+    if (fd < 0) {
+        // Disconnected since the messages were queued
+        loopStats.dropped += queue.waiting.size();
+        queue.waiting.clear();
+        return;
+    }
+
+    // A chain must go to the kernel in one submission, or its link breaks
+    if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) {
+        enter(sqPending, 0, 0);
+    }
+    std::size_t room = sqEntries - (sqLocalTail - loadAcquire(sqHead));
+    io_uring_sqe* last = nullptr;
+    while (!queue.waiting.empty() && !freeSendSlots.empty() && room > 0) {
+        uint16_t slot = freeSendSlots.back();
+        std::size_t size = codec->encode(queue.waiting.front(), sendSlots[slot]);
+        queue.waiting.pop_front();
+        if (size == 0) {
+            ++loopStats.dropped;
+            continue;
+        }
+        freeSendSlots.pop_back();
+        slotOwners[slot] = &queue;
+
+        io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = fd;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->addr = reinterpret_cast<uint64_t>(sendSlots[slot].data());
+        sqe->len = static_cast<uint32_t>(size);
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = (static_cast<uint64_t>(slot) << 3) | TAG_SEND;
+        last = sqe;
+        ++queue.inFlight;
+        ++queuedSends;
+        --room;
+    }
+    if (last) {
+        last->flags = 0;
+    }
+}
+
+void UringEventLoop::completeSend(const io_uring_cqe& cqe) {
+    uint16_t slot = static_cast<uint16_t>(cqe.user_data >> 3);
+    SendQueue* queue = slotOwners[slot];
+    slotOwners[slot] = nullptr;
+    freeSendSlots.push_back(slot);
+    // A failed send cancels the rest of its chain (-ECANCELED)
+    if (cqe.res <= 0) {
+        ++loopStats.dropped;
+    }
+    if (--queue->inFlight > 0) {
+        return;
+    }
+    if (queue->dead) {
+        sendQueues.erase(std::find_if(sendQueues.begin(), sendQueues.end(),
+            [queue](const std::unique_ptr<SendQueue>& q) { return q.get() == queue; }));
+    } else if (!queue->waiting.empty()) {
+        // Submitted with the next wait, or sooner by flush()
+        stageChain(*queue);
+    }
+}
+
+void UringEventLoop::drain(Entry& entry) {
+    MessageView view;
+    std::size_t count = 0;
+    while (count < MAX_BATCH && !entry.dead && entry.transport->receiveView(view)) {
+        entry.onMessage(view);
+        ++count;
+    }
+    loopStats.messages += count;
+    loopStats.syscalls += count + (count < MAX_BATCH ? 1 : 0);
+}
+
+void UringEventLoop::completeRecv(Entry& entry, const io_uring_cqe& cqe) {
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        std::size_t size = cqe.res > 0 ? static_cast<std::size_t>(cqe.res) : 0;
+        std::span<const uint8_t> packet{ recvBuffers[bid].data(), size };
+        BusCodec& codec = *entry.transport->packetCodec();
+
+        // Binary frames are handed over in place; the buffer goes back to
+        // the kernel only after the handler returns
+        Message msg;
+        MessageView view;
+        bool valid = false;
+        if (size > 0 && codec.format() == WireFormat::BINARY) {
+            valid = MessageView::parse(packet, view) == WireStatus::OK;
+        } else if (size > 0 && codec.decode(packet, msg)) {
+            view = MessageView(msg);
+            valid = true;
+        }
+        if (valid) {
+            entry.onMessage(view);
+            ++loopStats.messages;
+        } else if (size > 0) {
+            std::cerr << "[UringEventLoop] Dropped malformed " << wireFormatName(codec.format()) << " packet" << std::endl;
+        }
+        recycleBuffer(bid);
+    }
+
+    if (entry.armed || entry.dead) {
+        return;
+    }
+    // The multishot recv has ended
+    if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+        // CQ pressure or out of buffers; both resolve once we have reaped
+        arm(entry);
+    } else if (cqe.res == -EINVAL && multishotRecv) {
+        std::cerr << "[UringEventLoop] Multishot recv unsupported, polling endpoints instead" << std::endl;
+        multishotRecv = false;
+        entry.kind = Kind::POLL;
+        arm(entry);
+    } else {
+        // EOF or error: let the transport notice the disconnect itself;
+        // refreshEndpoints() re-arms once it has reconnected
+        drain(entry);
+    }
+}
+
+void UringEventLoop::complete(const io_uring_cqe& cqe) {
+    if (cqe.user_data & TAG_SEND) {
+        completeSend(cqe);
+        return;
+    }
+    if (cqe.user_data & TAG_IGNORE) {
+        return;
+    }
+
+    Entry& entry = *reinterpret_cast<Entry*>(cqe.user_data);
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        entry.armed = false;
+    }
+    if (entry.dead) {
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            recycleBuffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+        if (!entry.armed) {
+            freeEntry(&entry);
+        }
+        return;
+    }
+
+    ++loopStats.events;
+    switch (entry.kind) {
+        case Kind::RECV:
+            completeRecv(entry, cqe);
+            break;
+        case Kind::POLL:
+            if (cqe.res > 0) {
+                drain(entry);
+                // A transport that just dropped its connection is re-armed by refreshEndpoints()
+                if (entry.transport->pollFd() == entry.fd) {
+                    arm(entry);
+                }
+            }
+            break;
+        case Kind::WATCH:
+            if (cqe.res > 0) {
+                entry.onReady();
+                arm(entry);
+            }
+            break;
+    }
+}
+
+void UringEventLoop::endCodecBatches() {
+    // Decoded messages have all been handled; codecs may recycle their memory
+    for (auto& entry : entries) {
+        if (entry->kind == Kind::RECV && !entry->dead) {
+            entry->transport->packetCodec()->endBatch();
+        }
+    }
+}
+
+void UringEventLoop::refreshEndpoints() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastRefresh < REFRESH_INTERVAL) {
+        return;
+    }
+    lastRefresh = now;
+
+    std::vector<Entry*> stale;
+    for (auto& entry : entries) {
+        if (!entry->transport || entry->dead) {
+            continue;
+        }
+        BusTransport& transport = *entry->transport;
+        if (transport.pollFd() < 0) {
+            // A zero-timeout wait lets lazily connecting transports retry
+            transport.waitReadable(0);
+        }
+        if (transport.pollFd() == entry->fd && transport.connectionGeneration() == entry->generation) {
+            arm(*entry);
+            continue;
+        }
+        stale.push_back(entry.get());
+    }
+
+    // Reconnected on a new descriptor: replace the entry, since completions
+    // for the old one may still be in flight
+    for (Entry* entry : stale) {
+        BusTransport& transport = *entry->transport;
+        Kind kind = transport.packetCodec() && multishotRecv ? Kind::RECV : Kind::POLL;
+        Entry* replacement = addEntry(kind, transport.pollFd(), &transport, entry->onMessage, {});
+        retire(*entry);
+        arm(*replacement);
+    }
+}
+
+int UringEventLoop::runOnce(int timeoutMs) {
+    // Queues held back by a chain in flight or by full send slots
+    stageSends();
+    bool ready = loadAcquire(cqTail) != *cqHead;
+    if (sqPending > 0 || !ready) {
+        enter(sqPending, ready || timeoutMs == 0 ? 0 : 1, timeoutMs);
+    }
+
+    unsigned head = *cqHead;
+    unsigned tail = loadAcquire(cqTail);
+    int handled = 0;
+
+    dispatching = true;
+    while (head != tail) {
+        io_uring_cqe cqe = cqes[head & cqMask];
+        ++head;
+        storeRelease(cqHead, head);
+        complete(cqe);
+        ++handled;
+    }
+    dispatching = false;
+
+    if (handled > 0) {
+        ++loopStats.wakeups;
+        endCodecBatches();
+    }
+    for (Entry* entry : deferredFrees) {
+        freeEntry(entry);
+    }
+    deferredFrees.clear();
+
+    refreshEndpoints();
+    return handled;
+}
+
+#endif // FIDGET_HAVE_IO_URING
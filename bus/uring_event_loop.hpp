@@ -0,0 +1,151 @@
+// uring_event_loop.hpp
+#pragma once
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define FIDGET_HAVE_IO_URING 1
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <linux/io_uring.h>
+#include "bus_codec.hpp"
+#include "bus_loop.hpp"
+#include "bus_transport.hpp"
+#include "message_types.hpp"
+
+// io_uring backend for BusLoop, driven through the raw syscalls so no
+// liburing is needed. Packet-socket endpoints use one multishot recv each,
+// filling buffers from a kernel-registered buffer ring; other transports and
+// raw descriptors are polled. Sends are staged as SQEs and submitted
+// together at the next flush() or wait, so a tick's worth of traffic costs
+// one io_uring_enter; BatchPolicy::maxMessages submits early. Sends never
+// outlive a dispatch pass, so the policy window is always met.
+//
+// The kernel may run SQEs of one submission in any order, so each endpoint
+// has at most one chain of sends in flight, linked with IOSQE_IO_LINK.
+// Messages sent meanwhile, or while every send slot is taken, wait in the
+// endpoint's queue for the next chain; none is ever written around the
+// ring. The constructor throws if the kernel lacks a feature it needs; use
+// makeBusLoop() to fall back to epoll.
+class UringEventLoop : public BusLoop {
+public:
+    static constexpr unsigned SQ_ENTRIES = 256;
+    static constexpr unsigned RECV_BUFFERS = 512;     // Power of two
+    static constexpr unsigned SEND_SLOTS = 512;
+    static constexpr std::size_t MAX_QUEUED_SENDS = 1024;     // Per endpoint, before dropping
+
+    UringEventLoop();
+    ~UringEventLoop() override;
+
+    UringEventLoop(const UringEventLoop&) = delete;
+    UringEventLoop& operator=(const UringEventLoop&) = delete;
+
+    bool addViewEndpoint(BusTransport& transport, ViewHandler onView) override;
+    void removeEndpoint(BusTransport& transport) override;
+    void addFd(int fd, std::function<void()> onReady) override;
+    void removeFd(int fd) override;
+    bool send(BusTransport& transport, const Message& msg) override;
+    void flush() override;
+    int runOnce(int timeoutMs) override;
+
+    const char* backendName() const override { return "io_uring"; }
+
+protected:
+    void wake() override;
+
+private:
+    enum class Kind : uint8_t {
+        RECV,       // Multishot recv on a packet socket
+        POLL,       // Oneshot poll, then drain through the transport
+        WATCH       // Oneshot poll, then call onReady
+    };
+
+    struct Entry {
+        Kind kind;
+        int fd;
+        BusTransport* transport;
+        uint32_t generation;
+        ViewHandler onMessage;
+        std::function<void()> onReady;
+        bool armed = false;       // An operation referencing this entry is in flight
+        bool dead = false;        // Removed; freed once no operation references it
+    };
+
+    // Sends to one packet-socket transport, in order
+    struct SendQueue {
+        BusTransport* transport;
+        std::deque<Message> waiting;    // Not yet staged
+        unsigned inFlight = 0;          // Sends of the current chain not yet completed
+        bool dead = false;              // Endpoint removed; freed once inFlight is 0
+    };
+
+    using FrameSlot = std::array<uint8_t, BusCodec::MAX_PACKET_SIZE>;
+
+    // Tags in the low bits of user_data; Entry pointers are 8-byte aligned
+    static constexpr uint64_t TAG_SEND = 1;
+    static constexpr uint64_t TAG_IGNORE = 2;
+    static constexpr uint16_t BUFFER_GROUP = 0;
+
+    void teardown();
+    io_uring_sqe* nextSqe();
+    int enter(unsigned toSubmit, unsigned minComplete, int timeoutMs);
+    void arm(Entry& entry);
+    void retire(Entry& entry);
+    void freeEntry(Entry* entry);
+    Entry* addEntry(Kind kind, int fd, BusTransport* transport, ViewHandler onMessage, std::function<void()> onReady);
+    void complete(const io_uring_cqe& cqe);
+    void completeRecv(Entry& entry, const io_uring_cqe& cqe);
+    void drain(Entry& entry);
+    void recycleBuffer(uint16_t bid);
+    void endCodecBatches();
+    void refreshEndpoints();
+    void stageSends();
+    void stageChain(SendQueue& queue);
+    void completeSend(const io_uring_cqe& cqe);
+
+    int ringFd = -1;
+    int wakeFd = -1;
+    bool dispatching = false;
+
+    // Submission queue
+    void* sqMapping = nullptr;
+    std::size_t sqMappingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    std::size_t sqesSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned sqLocalTail = 0;
+    unsigned sqPending = 0;
+
+    // Completion queue (shares sqMapping)
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cqMask = 0;
+
+    // Provided buffer ring for multishot recv
+    io_uring_buf_ring* bufRing = nullptr;
+    std::size_t bufRingSize = 0;
+    std::unique_ptr<FrameSlot[]> recvBuffers;
+    uint16_t bufTail = 0;
+
+    // Encoded packets for sends in flight
+    std::unique_ptr<FrameSlot[]> sendSlots;
+    std::vector<SendQueue*> slotOwners;
+    std::vector<uint16_t> freeSendSlots;
+    std::vector<std::unique_ptr<SendQueue>> sendQueues;
+    std::size_t queuedSends = 0;    // Send SQEs not yet submitted
+
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::vector<Entry*> deferredFrees;
+    std::chrono::steady_clock::time_point lastRefresh{};
+    bool multishotRecv = true;
+};
+
+#endif // __linux__ && <linux/io_uring.h>
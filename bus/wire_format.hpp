@@ -0,0 +1,314 @@
+// wire_format.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "message_registry.hpp"
+#include "message_types.hpp"
+
+// Compact binary frame for Messages that cross a process boundary:
+//
+//   u16  length        Bytes after this field, little-endian
+//   u8   version:4 | flags:4
+//   u8   type          MessageType
+//   u8   lane
+//   var  from, to, seq
+//   ...  payload       Per type, see WireCodec
+//   u32  crc32c        Over version..payload, only with WIRE_FLAG_CRC
+//
+// Varints are LEB128 and signed values are zigzag-encoded first, so the
+// common case (small symbol ids, 1-byte payload fields) is 9-12 bytes. Tick
+// and enqueue time are not sent; the receiving bus stamps its own.
+// Encoding and decoding work in caller-provided buffers and never allocate.
+
+inline constexpr uint8_t WIRE_VERSION = 1;
+inline constexpr uint8_t WIRE_FLAG_CRC = 0x01;
+inline constexpr std::size_t WIRE_LENGTH_BYTES = 2;
+inline constexpr std::size_t MAX_FRAME_SIZE = 32;     // Worst case is 28
+
+enum class WireStatus : uint8_t {
+    OK = 0,
+    INCOMPLETE,      // Need more bytes; consumed is 0
+    BAD_LENGTH,      // Length field out of range or disagrees with the contents
+    BAD_VERSION,
+    BAD_TYPE,
+    BAD_CRC
+};
+
+struct WireDecodeResult {
+    WireStatus status;
+    std::size_t consumed;    // Frame size, so a rejected frame can be skipped; 0 if
+                             // INCOMPLETE or the length field itself is unusable
+};
+
+namespace detail {
+
+    inline uint8_t* putVarint(uint8_t* p, uint32_t value) {
+        while (value >= 0x80) {
+            *p++ = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        *p++ = static_cast<uint8_t>(value);
+        return p;
+    }
+
+    inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 35 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Up to ten bytes; protobuf writes negative int32 fields this way
+    inline uint8_t* putVarint64(uint8_t* p, uint64_t value) {
+        while (value >= 0x80) {
+            *p++ = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        *p++ = static_cast<uint8_t>(value);
+        return p;
+    }
+
+    inline bool getVarint64(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 70 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool getSymbol(const uint8_t*& p, const uint8_t* end, SymbolId& id) {
+        uint32_t value;
+        if (!getVarint(p, end, value) || value > UINT16_MAX) {
+            return false;
+        }
+        id = static_cast<SymbolId>(value);
+        return true;
+    }
+
+    inline uint32_t zigzag(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    inline int32_t unzigzag(uint32_t value) {
+        return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    inline uint64_t zigzag64(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t unzigzag64(uint64_t value) {
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    // CRC-32C (Castagnoli), reflected, table-driven
+    inline constexpr auto crc32cTable = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    inline uint32_t crc32c(const uint8_t* data, std::size_t size) {
+        uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc = crc32cTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+} // namespace detail
+
+// Per-payload wire encoding. Adding a payload to RegisteredPayloads means
+// adding a WireCodec specialization here as well.
+template <typename T>
+struct WireCodec; // Left undefined: unregistered types fail to compile
+
+template <>
+struct WireCodec<ButtonPress> {
+    static uint8_t* encode(uint8_t* p, const ButtonPress& press) {
+        p = detail::putVarint(p, press.button_id);
+        *p++ = press.pressed ? 1 : 0;
+        return p;
+    }
+
+    static bool decode(const uint8_t*& p, const uint8_t* end, ButtonPress& press) {
+        if (!detail::getSymbol(p, end, press.button_id) || p >= end) {
+            return false;
+        }
+        press.pressed = *p++ != 0;
+        return true;
+    }
+};
+
+template <>
+struct WireCodec<StateTransition> {
+    static uint8_t* encode(uint8_t* p, const StateTransition& transition) {
+        *p++ = transition.phase;
+        return p;
+    }
+
+    static bool decode(const uint8_t*& p, const uint8_t* end, StateTransition& transition) {
+        if (p >= end) {
+            return false;
+        }
+        transition.phase = *p++;
+        return true;
+    }
+};
+
+template <>
+struct WireCodec<AnalogSample> {
+    static uint8_t* encode(uint8_t* p, const AnalogSample& sample) {
+        p = detail::putVarint(p, sample.channel);
+        return detail::putVarint(p, detail::zigzag(sample.value));
+    }
+
+    static bool decode(const uint8_t*& p, const uint8_t* end, AnalogSample& sample) {
+        uint32_t value;
+        if (!detail::getSymbol(p, end, sample.channel) || !detail::getVarint(p, end, value)) {
+            return false;
+        }
+        sample.value = detail::unzigzag(value);
+        return true;
+    }
+};
+
+namespace detail {
+
+    template <typename T>
+    bool decodePayloadAs(const uint8_t*& p, const uint8_t* end, Message& msg) {
+        T value{};
+        if (!WireCodec<T>::decode(p, end, value)) {
+            return false;
+        }
+        PayloadTraits<T>::set(msg, value);
+        return true;
+    }
+
+    template <typename... Ts>
+    bool decodePayload(PayloadList<Ts...>, MessageType type, const uint8_t*& p, const uint8_t* end, Message& msg) {
+        bool ok = true; // NONE carries no payload
+        ((type == PayloadTraits<Ts>::type ? (ok = decodePayloadAs<Ts>(p, end, msg), true) : false) || ...);
+        return ok;
+    }
+
+} // namespace detail
+
+// Encode msg into out, which must hold at least MAX_FRAME_SIZE bytes.
+// Returns the frame size, or 0 if out is too small.
+inline std::size_t encodeFrame(const Message& msg, std::span<uint8_t> out, bool withCrc = false) {
+    if (out.size() < MAX_FRAME_SIZE) {
+        return 0;
+    }
+
+    uint8_t* start = out.data();
+    uint8_t* p = start + WIRE_LENGTH_BYTES;
+    *p++ = static_cast<uint8_t>((WIRE_VERSION << 4) | (withCrc ? WIRE_FLAG_CRC : 0));
+    *p++ = static_cast<uint8_t>(msg.type);
+    *p++ = static_cast<uint8_t>(msg.lane);
+    p = detail::putVarint(p, msg.from);
+    p = detail::putVarint(p, msg.to);
+    p = detail::putVarint(p, msg.seq);
+    dispatchMessage(msg, [&p](const auto& payload) {
+        p = WireCodec<std::decay_t<decltype(payload)>>::encode(p, payload);
+    });
+
+    if (withCrc) {
+        uint32_t crc = detail::crc32c(start + WIRE_LENGTH_BYTES, static_cast<std::size_t>(p - start) - WIRE_LENGTH_BYTES);
+        for (int i = 0; i < 4; ++i) {
+            *p++ = static_cast<uint8_t>(crc >> (8 * i));
+        }
+    }
+
+    std::size_t length = static_cast<std::size_t>(p - start) - WIRE_LENGTH_BYTES;
+    start[0] = static_cast<uint8_t>(length);
+    start[1] = static_cast<uint8_t>(length >> 8);
+    return WIRE_LENGTH_BYTES + length;
+}
+
+// Total size of the frame at the start of in, or 0 if the length field is
+// not complete yet
+inline std::size_t peekFrameSize(std::span<const uint8_t> in) {
+    if (in.size() < WIRE_LENGTH_BYTES) {
+        return 0;
+    }
+    return WIRE_LENGTH_BYTES + (static_cast<std::size_t>(in[0]) | (static_cast<std::size_t>(in[1]) << 8));
+}
+
+// Decode one frame from the start of in. Fields not carried on the wire
+// (tick, enqueueNs) are zeroed; wireBytes is set to the frame size.
+inline WireDecodeResult decodeFrame(std::span<const uint8_t> in, Message& msg) {
+    std::size_t frameSize = peekFrameSize(in);
+    if (frameSize == 0) {
+        return { WireStatus::INCOMPLETE, 0 };
+    }
+    if (frameSize > MAX_FRAME_SIZE || frameSize < WIRE_LENGTH_BYTES + 3) {
+        return { WireStatus::BAD_LENGTH, 0 };
+    }
+    if (in.size() < frameSize) {
+        return { WireStatus::INCOMPLETE, 0 };
+    }
+
+    const uint8_t* body = in.data() + WIRE_LENGTH_BYTES;
+    const uint8_t* end = in.data() + frameSize;
+    uint8_t versionFlags = body[0];
+    if ((versionFlags >> 4) != WIRE_VERSION) {
+        return { WireStatus::BAD_VERSION, frameSize };
+    }
+    if (versionFlags & WIRE_FLAG_CRC) {
+        if (end - body < 4 + 3) {
+            return { WireStatus::BAD_LENGTH, frameSize };
+        }
+        end -= 4;
+        uint32_t expected = static_cast<uint32_t>(end[0]) | (static_cast<uint32_t>(end[1]) << 8) |
+                            (static_cast<uint32_t>(end[2]) << 16) | (static_cast<uint32_t>(end[3]) << 24);
+        if (detail::crc32c(body, static_cast<std::size_t>(end - body)) != expected) {
+            return { WireStatus::BAD_CRC, frameSize };
+        }
+    }
+    if (body[1] >= MESSAGE_TYPE_COUNT || body[2] >= LANE_COUNT) {
+        return { WireStatus::BAD_TYPE, frameSize };
+    }
+
+    msg = Message{};
+    msg.type = static_cast<MessageType>(body[1]);
+    msg.lane = static_cast<Lane>(body[2]);
+    const uint8_t* p = body + 3;
+    if (!detail::getSymbol(p, end, msg.from) || !detail::getSymbol(p, end, msg.to) ||
+        !detail::getVarint(p, end, msg.seq) ||
+        !detail::decodePayload(RegisteredPayloads{}, msg.type, p, end, msg) || p != end) {
+        return { WireStatus::BAD_LENGTH, frameSize };
+    }
+    msg.wireBytes = static_cast<uint8_t>(frameSize);
+    return { WireStatus::OK, frameSize };
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::OK: return "ok";
+        case WireStatus::INCOMPLETE: return "incomplete";
+        case WireStatus::BAD_LENGTH: return "bad length";
+        case WireStatus::BAD_VERSION: return "bad version";
+        case WireStatus::BAD_TYPE: return "bad type";
+        case WireStatus::BAD_CRC: return "bad crc";
+        default: return "unknown";
+    }
+}
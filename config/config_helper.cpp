@@ -5,8 +5,13 @@
 #include "nlohmann/json.hpp"
 #include "../bus/pin_sim.hpp" // Updated include path for pin_sim.hpp
 #include "../bus/pipe_bus_client.hpp" // Updated to use PipeBusClient instead of BusClient
+#include "../bus/symbol_table.hpp"
+#ifdef __linux__
+#include "../bus/shm_transport.hpp"
+#include "../bus/uds_transport.hpp"
+#endif
 
-nlohmann::json ConfigHelper::loadControllerConfig(const std::string& controllerName, const std::string& configFilePath) {
+nlohmann::json ConfigHelper::loadConfig(const std::string& configFilePath) {
     std::ifstream configFile(configFilePath);
     if (!configFile.is_open()) {
         throw std::runtime_error("Failed to open configuration file: " + configFilePath);
@@ -15,6 +20,15 @@ nlohmann::json ConfigHelper::loadControllerConfig(const std::string& controllerN
     nlohmann::json configJson;
     configFile >> configJson;
 
+    internSymbols(configJson);
+    return configJson;
+}
+
+nlohmann::json ConfigHelper::loadControllerConfig(const std::string& controllerName, const std::string& configFilePath) {
+    return controllerConfig(loadConfig(configFilePath), controllerName);
+}
+
+nlohmann::json ConfigHelper::controllerConfig(const nlohmann::json& configJson, const std::string& controllerName) {
     if (configJson.contains("main_controller") && controllerName == "main_controller") {
         return configJson["main_controller"];
     }
@@ -28,6 +42,51 @@ nlohmann::json ConfigHelper::loadControllerConfig(const std::string& controllerN
     throw std::runtime_error("Controller configuration not found for: " + controllerName);
 }
 
+void ConfigHelper::internSymbols(const nlohmann::json& config) {
+    SymbolTable& table = symbols();
+
+    if (config.contains("main_controller")) {
+        table.intern("main_controller");
+        for (const char* section : {"listen_for", "analog_channels"}) {
+            for (const auto& signal : config["main_controller"].value(section, nlohmann::json::array())) {
+                table.intern(signal.get<std::string>());
+            }
+        }
+    }
+
+    // Controller names and their fully qualified pins, e.g. phc_a:PB0
+    for (const auto& controller : config.value("peripheral_controllers", nlohmann::json::array())) {
+        std::string name = controller["name"].get<std::string>();
+        table.intern(name);
+        if (controller.contains("chip") && controller["chip"].contains("pins")) {
+            for (const auto& pin : controller["chip"]["pins"]) {
+                table.intern(name + ":" + pin.get<std::string>());
+            }
+        }
+    }
+
+    // Wiring aliases (MASTER, SCRAM) and the pins they target
+    if (config.contains("wiring")) {
+        for (const auto& [owner, signals] : config["wiring"].items()) {
+            table.intern(owner);
+            for (const auto& [alias, details] : signals.items()) {
+                table.intern(alias);
+                if (details.contains("target")) {
+                    table.intern(details["target"].get<std::string>());
+                }
+            }
+        }
+    }
+
+    for (const char* section : {"controller_pipes", "phy_pipes"}) {
+        for (const auto& pipe : config.value(section, nlohmann::json::array())) {
+            table.intern(pipe.get<std::string>());
+        }
+    }
+
+    std::cout << "[ConfigHelper] Interned " << table.size() - 1 << " symbols" << std::endl;
+}
+
 void ConfigHelper::validateWiring(const nlohmann::json& wiringConfig, const nlohmann::json& componentsConfig) {
     for (const auto& [controllerName, pins] : wiringConfig.items()) {
         std::cout << "Validating wiring for: " << controllerName << std::endl;
@@ -49,15 +108,28 @@ void ConfigHelper::validateWiring(const nlohmann::json& wiringConfig, const nloh
     }
 }
 
+WireFormat ConfigHelper::wireFormat(const nlohmann::json& controllerConfig) {
+    std::string name = controllerConfig.value("wire_format", "binary");
+    if (name == "protobuf") {
+        return WireFormat::PROTOBUF;
+    }
+    if (name != "binary") {
+        std::cerr << "[ConfigHelper] Unknown wire_format " << name << ", using binary" << std::endl;
+    }
+    return WireFormat::BINARY;
+}
+
 void ConfigHelper::initializePipes(const nlohmann::json& config) {
-    // Create pipes for controller communication (controller_pipes)
+    // Create pipes for controller communication (controller_pipes). These
+    // carry the main controller's bus link, so they speak its wire format.
     if (config.contains("controller_pipes")) {
+        WireFormat format = config.contains("main_controller") ? wireFormat(config["main_controller"]) : WireFormat::BINARY;
         for (const auto& pipeName : config["controller_pipes"]) {
             std::string pipe = pipeName.get<std::string>();
-            std::cout << "[ConfigHelper] Initializing controller pipe: " << pipe << std::endl;
+            std::cout << "[ConfigHelper] Initializing controller pipe: " << pipe << " (" << wireFormatName(format) << ")" << std::endl;
             
             // Create the named pipe
-            createNamedPipe(pipe);
+            createNamedPipe(pipe, format);
         }
     }
 
@@ -73,7 +145,36 @@ void ConfigHelper::initializePipes(const nlohmann::json& config) {
     }
 }
 
-void ConfigHelper::createNamedPipe(const std::string& pipeName) {
+#ifdef __linux__
+std::unordered_map<std::string, std::unique_ptr<UdsServerTransport>>& ConfigHelper::pipeEndpoints() {
+    static std::unordered_map<std::string, std::unique_ptr<UdsServerTransport>> endpoints;
+    return endpoints;
+}
+
+std::size_t ConfigHelper::hostPipes(const nlohmann::json& config, BusLoop& loop) {
+    initializePipes(config);
+    for (auto& [pipe, endpoint] : pipeEndpoints()) {
+        UdsServerTransport* server = endpoint.get();
+        loop.addEndpoint(*server, [server](const Message& msg) { server->relay(msg); });
+        std::cout << "[ConfigHelper] Hosting pipe: " << pipe << std::endl;
+    }
+    return pipeEndpoints().size();
+}
+
+void ConfigHelper::createNamedPipe(const std::string& pipeName, WireFormat format) {
+    if (pipeEndpoints().count(pipeName)) {
+        return;
+    }
+    try {
+        pipeEndpoints().emplace(pipeName, std::make_unique<UdsServerTransport>(pipeName, makeBusCodec(format)));
+        std::cout << "[ConfigHelper] Successfully created socket endpoint: " << pipeName << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[ConfigHelper] Failed to create socket endpoint " << pipeName << ". Error: " << e.what() << std::endl;
+    }
+}
+#else
+void ConfigHelper::createNamedPipe(const std::string& pipeName, WireFormat) {
+    // The wire format is chosen by clients; this end only creates the pipe
     std::string pipePath = "\\\\.\\pipe\\" + pipeName;
     
     HANDLE hPipe = CreateNamedPipeA(
@@ -101,6 +202,7 @@ void ConfigHelper::createNamedPipe(const std::string& pipeName) {
     // For simplicity, we're not keeping track of the handles which means they won't be properly closed
     // In a real implementation, you'd want to store these and close them on shutdown
 }
+#endif
 
 void ConfigHelper::setupPinSimWiring(const nlohmann::json& wiringConfig, std::unordered_map<std::string, PinSim>& pinSims) {
     for (const auto& [signal, details] : wiringConfig.items()) {
@@ -113,10 +215,136 @@ void ConfigHelper::setupPinSimWiring(const nlohmann::json& wiringConfig, std::un
     }
 }
 
+void ConfigHelper::setupWiringSignals(const nlohmann::json& config, MessageBus& bus) {
+    if (!config.contains("wiring")) {
+        return;
+    }
+
+    for (const auto& [owner, signals] : config["wiring"].items()) {
+        for (const auto& [signal, details] : signals.items()) {
+            if (!details.contains("target")) {
+                continue;
+            }
+            std::string target = details["target"].get<std::string>();
+            std::cout << "[ConfigHelper] Treating " << target << " as " << signal << std::endl;
+            bus.addSignal(symbols().intern(target), symbols().intern(signal));
+        }
+    }
+}
+
+void ConfigHelper::setupPriorityLanes(const nlohmann::json& controllerConfig, MessageBus& bus) {
+    if (!controllerConfig.contains("priority_lanes")) {
+        return;
+    }
+
+    const auto& lanes = controllerConfig["priority_lanes"];
+    for (const auto& [laneName, signals] : lanes.items()) {
+        Lane lane;
+        if (laneName == "safety") {
+            lane = Lane::SAFETY;
+        } else if (laneName == "control") {
+            lane = Lane::CONTROL;
+        } else if (laneName == "telemetry") {
+            lane = Lane::TELEMETRY;
+        } else {
+            std::cerr << "[ConfigHelper] Unknown priority lane: " << laneName << std::endl;
+            continue;
+        }
+
+        for (const auto& signal : signals) {
+            std::string name = signal.get<std::string>();
+            std::cout << "[ConfigHelper] Routing " << name << " through the " << laneName << " lane" << std::endl;
+            bus.assignLane(symbols().intern(name), lane);
+        }
+    }
+}
+
+void ConfigHelper::setupListenRoutes(const nlohmann::json& controllerConfig, MessageBus& bus, SubscriberId subscriber) {
+    if (!controllerConfig.contains("listen_for")) {
+        return;
+    }
+
+    for (const auto& signal : controllerConfig["listen_for"]) {
+        std::string name = signal.get<std::string>();
+        std::cout << "[ConfigHelper] Routing " << name << " to " << symbols().name(bus.routes().subscriberName(subscriber)) << std::endl;
+        bus.routes().subscribe(subscriber, symbols().intern(name), MessageType::BUTTON_PRESS);
+    }
+}
+
+void ConfigHelper::setupAnalogChannels(const nlohmann::json& controllerConfig, MessageBus& bus) {
+    if (!controllerConfig.contains("analog_channels")) {
+        return;
+    }
+
+    for (const auto& channel : controllerConfig["analog_channels"]) {
+        std::string name = channel.get<std::string>();
+        std::cout << "[ConfigHelper] Conflating analog channel: " << name << std::endl;
+        bus.addAnalogChannel(symbols().intern(name));
+    }
+}
+
 void ConfigHelper::setupControllerBus(const nlohmann::json& config, PipeBusClient& busClient) {
     if (config.contains("shared_pipe")) {
         std::string sharedPipe = config["shared_pipe"].get<std::string>();
+#ifdef __linux__
+        if (config.value("bus_transport", "pipe") == "shm") {
+            // Frames are not encoded on this link, so wire_format does not apply
+            std::string name = config.value("name", "main_controller");
+            std::cout << "[ConfigHelper] Setting up controller bus in shared memory: " << name << " <-> " << sharedPipe << std::endl;
+            try {
+                // Pollable, so the controller's event loop wakes as soon as a message lands
+                busClient.attach(std::make_shared<ShmTransport>(name, sharedPipe, ShmTransport::DEFAULT_CAPACITY, true));
+            } catch (const std::exception& e) {
+                std::cerr << "[ConfigHelper] Failed to map controller bus: " << e.what() << std::endl;
+            }
+            return;
+        }
+#endif
         std::cout << "[ConfigHelper] Setting up controller bus on shared pipe: " << sharedPipe << std::endl;
-        // Logic to initialize the BusClient with the shared pipe
+        busClient.connect(sharedPipe, wireFormat(config));
+    }
+}
+
+#ifdef __linux__
+std::vector<std::unique_ptr<BusBridge>> ConfigHelper::setupBridges(const nlohmann::json& controllerConfig, BusLoop& loop,
+                                                                   BusLoop::MessageHandler onRemote) {
+    std::vector<std::unique_ptr<BusBridge>> bridges;
+    for (const auto& entry : controllerConfig.value("bridges", nlohmann::json::array())) {
+        BusBridge::Config bridgeConfig;
+        bridgeConfig.name = entry.value("name", "bridge");
+        bridgeConfig.listen = entry.value("listen", "");
+        bridgeConfig.connect = entry.value("connect", "");
+        bridgeConfig.batching.maxMessages = entry.value("flush_max_messages", bridgeConfig.batching.maxMessages);
+        bridgeConfig.batching.window = std::chrono::microseconds(
+            entry.value("flush_window_us", static_cast<int>(bridgeConfig.batching.window.count())));
+
+        // "*" matches any sender or destination
+        auto routeSymbol = [](const nlohmann::json& route, const char* key) {
+            std::string name = route.value(key, "*");
+            return name == "*" ? NO_SYMBOL : symbols().intern(name);
+        };
+        for (const auto& route : entry.value("routes", nlohmann::json::array())) {
+            bridgeConfig.routes.push_back({ routeSymbol(route, "from"), routeSymbol(route, "to") });
+        }
+
+        std::shared_ptr<BusTransport> local;
+        if (entry.contains("pipe")) {
+            // A connection of its own, so the bridge can register it with the loop
+            std::string pipe = entry["pipe"].get<std::string>();
+            local = std::make_shared<UdsClientTransport>(pipe, makeBusCodec(wireFormat(entry)));
+        }
+
+        try {
+            auto bridge = std::make_unique<BusBridge>(loop, std::move(local), std::move(bridgeConfig));
+            if (onRemote) {
+                bridge->onRemote(onRemote);
+            }
+            std::cout << "[ConfigHelper] Bridge " << bridge->name() << " ready" << std::endl;
+            bridges.push_back(std::move(bridge));
+        } catch (const std::exception& e) {
+            std::cerr << "[ConfigHelper] Failed to start bridge: " << e.what() << std::endl;
+        }
     }
-}
\ No newline at end of file
+    return bridges;
+}
+#endif
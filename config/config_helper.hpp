@@ -3,27 +3,85 @@
 #include <vector>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
+#include "../bus/bus_codec.hpp"
 #include "../bus/pin_sim.hpp"
 #include "../bus/pipe_bus_client.hpp"
+#include "../bus/message_bus.hpp"
+#ifdef __linux__
+#include "../bus/bus_bridge.hpp"
+#include "../bus/bus_loop.hpp"
+#include "../bus/uds_transport.hpp"
+#endif
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 class ConfigHelper {
 public:
+    // Load the whole configuration file, interning its symbols
+    static nlohmann::json loadConfig(const std::string& configFilePath);
+
     // Load a specific controller's configuration from the JSON file
     static nlohmann::json loadControllerConfig(const std::string& controllerName, const std::string& configFilePath);
 
+    // A specific controller's section of an already loaded configuration
+    static nlohmann::json controllerConfig(const nlohmann::json& config, const std::string& controllerName);
+
+    // Intern controller names, pin aliases and pipe names into the global symbol table
+    static void internSymbols(const nlohmann::json& config);
+
     // Validate wiring configuration
     static void validateWiring(const nlohmann::json& wiringConfig, const nlohmann::json& componentsConfig);
 
     // Initialize named pipes from configuration
     static void initializePipes(const nlohmann::json& config);
     
-    // Create a named pipe with the given name
-    static void createNamedPipe(const std::string& pipeName);
+    // Create a named pipe with the given name. On Linux this is a
+    // SOCK_SEQPACKET Unix socket endpoint, kept open in pipeEndpoints(),
+    // speaking the given wire format.
+    static void createNamedPipe(const std::string& pipeName, WireFormat format = WireFormat::BINARY);
+
+    // Wire format named by a controller's "wire_format" ("binary" or "protobuf")
+    static WireFormat wireFormat(const nlohmann::json& controllerConfig);
+
+#ifdef __linux__
+    // Server endpoints created by createNamedPipe, keyed by pipe name
+    static std::unordered_map<std::string, std::unique_ptr<UdsServerTransport>>& pipeEndpoints();
+
+    // Create the controller_pipes and phy_pipes endpoints and serve them from
+    // loop, so a headless process can stand in for the debug UI that hosts
+    // them on Windows. Whatever a peer writes to a pipe is relayed to the
+    // pipe's other peers. Returns the number of pipes served.
+    static std::size_t hostPipes(const nlohmann::json& config, BusLoop& loop);
+#endif
 
     // Set up PinSim wiring based on configuration
     static void setupPinSimWiring(const nlohmann::json& wiringConfig, std::unordered_map<std::string, PinSim>& pinSims);
     
-    // Set up controller bus client
+    // Map each pin in the wiring section back to the signal it carries, so
+    // a press from phc_a:PB1 is handled as SCRAM. Call before the lanes and
+    // routes below are used; config is the whole simulation config.
+    static void setupWiringSignals(const nlohmann::json& config, MessageBus& bus);
+
+    // Assign signals listed under priority_lanes to the SAFETY/TELEMETRY lanes
+    static void setupPriorityLanes(const nlohmann::json& controllerConfig, MessageBus& bus);
+
+    // Subscribe a consumer to the ButtonPress signals named in listen_for
+    static void setupListenRoutes(const nlohmann::json& controllerConfig, MessageBus& bus, SubscriberId subscriber);
+
+    // Register the slider inputs listed under analog_channels as conflated channels
+    static void setupAnalogChannels(const nlohmann::json& controllerConfig, MessageBus& bus);
+
+    // Set up controller bus client. On Linux, "bus_transport": "shm" links it
+    // to shared_pipe through ShmTransport rings instead of a socket; the
+    // client must then be read through attach_to(), not start_receiving().
     static void setupControllerBus(const nlohmann::json& config, PipeBusClient& busClient);
+
+#ifdef __linux__
+    // Start the TCP bridges listed under "bridges" on loop. A bridge with a
+    // "pipe" forwards matching traffic from it; everything the peer sends
+    // goes to onRemote. The bridges must be destroyed before the loop.
+    static std::vector<std::unique_ptr<BusBridge>> setupBridges(const nlohmann::json& controllerConfig, BusLoop& loop,
+                                                                BusLoop::MessageHandler onRemote);
+#endif
 };
\ No newline at end of file
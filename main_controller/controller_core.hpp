@@ -1,11 +1,8 @@
 // controller_core.hpp
 #pragma once
 
-#include <vector>
-#include <string>
 #include <cstdint>
-#include <optional>
-#include "../bus/message_types.hpp"
+#include "../bus/message_bus.hpp"
 
 // Central controller state for each tick
 struct ControllerState {
@@ -20,12 +17,17 @@ struct ControllerState {
 
     bool scramEngaged = false;
     bool allSubsystemsOnline = false;
+};
 
-    std::vector<Message> inboundMessages;
-    std::vector<Message> outboundMessages;
+// FNV-1a over ControllerState, chained from STATE_DIGEST_SEED through every
+// tick. A live run and its replay print the same digest when they agree.
+inline constexpr uint64_t STATE_DIGEST_SEED = 14695981039346656037ull;
 
-    void resetMessages() {
-        inboundMessages.clear();
-        outboundMessages.clear();
+inline uint64_t digestState(uint64_t digest, const ControllerState& state) {
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+    for (uint64_t field : { static_cast<uint64_t>(state.phase), static_cast<uint64_t>(state.scramEngaged),
+                            static_cast<uint64_t>(state.allSubsystemsOnline) }) {
+        digest = (digest ^ field) * FNV_PRIME;
     }
-};
+    return digest;
+}
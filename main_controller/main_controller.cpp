@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <thread>
 #include <chrono>
 #include <memory>
@@ -9,16 +10,114 @@
 #include "subsystems/gen_system.hpp"
 #include "subsystems/xfer_system.hpp"
 #include "../bus/pipe_bus_client.hpp"
+#include "../bus/symbol_table.hpp"
+#include "../config/config_helper.hpp"
+#ifdef __linux__
+#include <csignal>
+#include "../bus/bus_loop.hpp"
+#include "../bus/state_feed_server.hpp"
+#include "../bus/state_publisher.hpp"
+#include "../bus/trace_reader.hpp"
+#include "../bus/trace_recorder.hpp"
+#include "replay_engine.hpp"
+#include "state_export.hpp"
+#endif
 
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "Starting Fidget Reactor simulation...\n";
     int tickCount = 0;
 
+    // --replay <recorded run directory> [--speed <multiple of real time> | --speed max]
+    std::string replayDirectory;
+    double replaySpeed = 1.0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay") {
+            replayDirectory = argv[++i];
+        } else if (arg == "--speed") {
+            std::string speed = argv[++i];
+            try {
+                replaySpeed = speed == "max" ? 0.0 : std::stod(speed);
+            } catch (const std::exception&) {
+                std::cerr << "[main_controller] Bad --speed " << speed << ", replaying at real time" << std::endl;
+            }
+        }
+    }
+    bool replaying = !replayDirectory.empty();
+#ifndef __linux__
+    if (replaying) {
+        std::cerr << "[main_controller] Replay is only supported on Linux" << std::endl;
+        return 1;
+    }
+#else
+    // Block shutdown signals before the recorder or feed start their
+    // threads, so they inherit the mask and only the loop's signalfd ever
+    // sees SIGINT/SIGTERM (the bus client blocks them in its own threads)
+    sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGINT);
+    sigaddset(&shutdownSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+#endif
+
+    // Loading the config interns controller names and pin aliases
+    nlohmann::json simulationConfig;
+    nlohmann::json config;
+    try {
+        simulationConfig = ConfigHelper::loadConfig("config/simulation_config.json");
+        config = ConfigHelper::controllerConfig(simulationConfig, "main_controller");
+    } catch (const std::exception& e) {
+        std::cerr << "[main_controller] Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    for (const char* subsystem : {"core_system", "ctrl_system", "gen_system", "xfer_system"}) {
+        symbols().intern(subsystem);
+    }
+
     ControllerState state;
+    MessageBus bus;
+    ConfigHelper::setupWiringSignals(simulationConfig, bus);
+    ConfigHelper::setupPriorityLanes(config, bus);
+    ConfigHelper::setupAnalogChannels(config, bus);
+
+    SubscriberId mainSubscriber = bus.routes().addSubscriber(symbols().intern("main_controller"));
+    ConfigHelper::setupListenRoutes(config, bus, mainSubscriber);
+    bus.buildRoutes();
+
+    // A replay takes its input from the trace, not the live bus
     auto bus_client = std::make_shared<PipeBusClient>("init"); 
+    if (!replaying) {
+        ConfigHelper::setupControllerBus(config, *bus_client);
+    }
+    bus_client->on_receive([&bus](const Message& msg) { bus.pushInbound(msg); });
+#ifdef __linux__
+    // One thread services the bus link, the tick timer and shutdown signals
+    BusBackend backend = config.value("bus_backend", "epoll") == "io_uring" ? BusBackend::IO_URING : BusBackend::EPOLL;
+    std::unique_ptr<BusLoop> loop = makeBusLoop(backend);
+    BusLoop::BatchPolicy batching;
+    batching.maxMessages = config.value("batch_max_messages", batching.maxMessages);
+    batching.window = std::chrono::microseconds(config.value("batch_window_us", static_cast<int>(batching.window.count())));
+    loop->setBatchPolicy(batching);
+
+    // No debug UI hosts the pipes here, so serve them before anything connects
+    if (!replaying) {
+        ConfigHelper::hostPipes(simulationConfig, *loop);
+    }
+
+    bus_client->attach_to(*loop);
+
+    // Peer buses federated over TCP feed the same inbound queue as the local link
+    std::vector<std::unique_ptr<BusBridge>> bridges;
+    if (!replaying) {
+        bridges = ConfigHelper::setupBridges(config, *loop, [&bus](const Message& msg) { bus.pushInbound(msg); });
+    }
+#else
+    bus_client->start_receiving();
+#endif
     InitManager testInit(state);
-    tickEngine::TickEngine engine(state);
+    tickEngine::TickEngine engine(state, bus);
 
     CoreSystem core(state);
     CtrlSystem ctrl(state);
@@ -32,6 +131,128 @@ int main() {
 
     engine.initialize_all();
 
+#ifdef __linux__
+    // UIs connect to the state feed for a snapshot, then per-tick deltas
+    StatePublisher statePublisher;
+    StateExport stateExport("main_controller", {"core_system", "ctrl_system", "gen_system", "xfer_system"});
+    std::unique_ptr<StateFeedServer> stateFeed;
+    if (config.contains("state_feed")) {
+        try {
+            stateFeed = std::make_unique<StateFeedServer>(*loop, statePublisher, config["state_feed"].get<std::string>());
+        } catch (const std::exception& e) {
+            std::cerr << "[main_controller] State feed disabled: " << e.what() << std::endl;
+        }
+    }
+
+    // Record everything crossing the tick boundary for later replay
+    std::unique_ptr<TraceRecorder> recorder;
+    if (config.contains("trace") && !replaying) {
+        const nlohmann::json& traceConfig = config["trace"];
+        TraceRecorder::Options traceOptions;
+        traceOptions.directory = traceConfig.value("directory", traceOptions.directory);
+        traceOptions.prefix = traceConfig.value("prefix", traceOptions.prefix);
+        traceOptions.segmentRecords = traceConfig.value("segment_records", traceOptions.segmentRecords);
+        traceOptions.compact = traceConfig.value("compact", traceOptions.compact);
+        try {
+            recorder = std::make_unique<TraceRecorder>(traceOptions);
+            bus.setTap(recorder.get());
+        } catch (const std::exception& e) {
+            std::cerr << "[main_controller] Tracing disabled: " << e.what() << std::endl;
+        }
+    }
+
+    // Everything after the engine's tick, live or replayed
+    auto finishTick = [&tickCount, &loop, &bus, &state, &statePublisher, &stateExport, &stateFeed] {
+        Message msg;
+        while (bus.popOutbound(msg)) {
+            statePublisher.apply(msg);
+        }
+        stateExport.update(statePublisher, state);
+        statePublisher.publish(static_cast<uint32_t>(tickCount));
+        if (stateFeed) {
+            stateFeed->flush();
+        }
+
+        // Submit everything the tick sent in one go
+        loop->flush();
+    };
+
+    int tickIntervalMs = config.value("tick_interval_ms", 50);
+    if (replaying) {
+        std::unique_ptr<TraceReader> trace;
+        try {
+            trace = std::make_unique<TraceReader>(replayDirectory, config.value("trace", nlohmann::json::object()).value("prefix", "bus"));
+        } catch (const std::exception& e) {
+            std::cerr << "[main_controller] Cannot replay: " << e.what() << std::endl;
+            return 1;
+        }
+
+        std::cout << "[main_controller] Replaying " << trace->recordCount() << " records from " << replayDirectory
+                  << (replaySpeed > 0 ? " at " + std::to_string(replaySpeed) + "x" : std::string(" as fast as possible"))
+                  << std::endl;
+        ReplayEngine replay(*trace, bus, engine, state);
+        loop->handleSignals({SIGINT, SIGTERM}, [&replay](int sig) {
+            std::cout << "[main_controller] Caught signal " << sig << ", stopping replay" << std::endl;
+            replay.stop();
+        });
+        ReplayEngine::Result result = replay.run(replaySpeed, std::chrono::milliseconds(tickIntervalMs), loop.get(),
+                                                 [&tickCount, &finishTick] {
+            ++tickCount;
+            finishTick();
+        });
+
+        std::cout << "[main_controller] Replayed " << result.ticks << " ticks in " << result.seconds << " s: "
+                  << result.injected << " messages injected, " << result.compared << " outbound matched, "
+                  << result.mismatches << " mismatched, state digest " << std::hex << result.stateDigest << std::dec
+                  << std::endl;
+        std::cout << "Replay complete.\n";
+        return result.mismatches == 0 ? 0 : 2;
+    }
+
+    // Same digest a replay of this run's trace prints
+    uint64_t stateDigest = STATE_DIGEST_SEED;
+    loop->addTimer(std::chrono::milliseconds(tickIntervalMs), [&engine, &tickCount, &finishTick, &state,
+                                                               &stateDigest](uint64_t expirations) {
+        // Catch up on missed ticks rather than drifting
+        for (uint64_t i = 0; i < expirations; ++i) {
+            engine.tick();
+            ++tickCount;
+            stateDigest = digestState(stateDigest, state);
+        }
+        finishTick();
+    });
+    loop->handleSignals({SIGINT, SIGTERM}, [&loop](int sig) {
+        std::cout << "[main_controller] Caught signal " << sig << ", shutting down" << std::endl;
+        loop->stop();
+    });
+    loop->run();
+
+    if (recorder) {
+        bus.setTap(nullptr);
+        recorder->close(bus.tick());
+    }
+
+    const BusLoop::Stats& loopStats = loop->stats();
+    std::cout << "[main_controller] " << tickCount << " ticks, " << loopStats.wakeups << " wakeups, "
+              << loopStats.messages << " bus messages, "
+              << loopStats.syscalls << " loop syscalls, state digest " << std::hex << stateDigest << std::dec
+              << std::endl;
+    if (loopStats.flushes > 0) {
+        std::cout << "[main_controller] " << loopStats.flushes << " send flushes, "
+                  << static_cast<double>(loopStats.flushedMessages) / static_cast<double>(loopStats.flushes)
+                  << " messages per flush (max " << loopStats.largestFlush << ")" << std::endl;
+    }
+    const StatePublisher::Stats& publisherStats = statePublisher.stats();
+    std::cout << "[main_controller] State feed: " << publisherStats.deltas << " deltas, "
+              << publisherStats.snapshots << " snapshots, " << publisherStats.bytesEncoded << " bytes encoded" << std::endl;
+    for (const auto& bridge : bridges) {
+        const BusBridge::Stats& bridgeStats = bridge->stats();
+        std::cout << "[main_controller] Bridge " << bridge->name() << ": " << bridgeStats.forwarded << " forwarded, "
+                  << bridgeStats.received << " received, " << bridgeStats.dropped << " dropped, "
+                  << bridgeStats.flushes << " flushes" << std::endl;
+    }
+#endif
+
     std::cout << "Simulation complete.\n";
     return 0;
 }
@@ -0,0 +1,223 @@
+// replay_engine.hpp
+#pragma once
+#ifdef __linux__
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <thread>
+#include <vector>
+#include "controller_core.hpp"
+#include "tick_engine.hpp"
+#include "../bus/bus_loop.hpp"
+#include "../bus/trace_reader.hpp"
+#include "../bus/wire_format.hpp"
+
+// Drives the tick engine from a recorded trace (bus/trace_recorder.hpp).
+// Before each tick, the inbound and analog traffic that tick originally saw
+// is injected into the bus, so the controller observes the same inputs on
+// the same ticks. Everything the tick emits is compared with the recorded
+// outbound traffic, which proves the run reproduced the original.
+//
+// Replay uses the recording's tick numbers, never wall time. It can run at
+// real time, at a multiple of real time, or as fast as possible; the pace
+// changes only when ticks happen, not what they compute. The trace must be
+// replayed with the config it was recorded under, so symbols intern to the
+// same ids.
+class ReplayEngine : public BusTap {
+public:
+    struct Result {
+        uint32_t ticks = 0;
+        uint64_t injected = 0;      // Inbound and analog records fed to the bus
+        uint64_t compared = 0;      // Outbound messages matched against the trace
+        uint64_t mismatches = 0;    // Outbound messages missing, extra or different
+        uint64_t stateDigest = 0;   // digestState() after every tick
+        double seconds = 0;
+    };
+
+    ReplayEngine(const TraceReader& trace, MessageBus& bus, tickEngine::TickEngine& engine, const ControllerState& state)
+        : trace(trace), bus(bus), engine(engine), state(state) {}
+
+    // speed 1 is real time, 4 four times faster; 0 or less runs as fast as
+    // possible. Between ticks, loop (if given) is serviced, and afterTick
+    // runs after each one as the live timer callback would.
+    Result run(double speed, std::chrono::milliseconds tickInterval, BusLoop* loop = nullptr,
+               std::function<void()> afterTick = nullptr) {
+        pace = { speed, tickInterval, std::chrono::steady_clock::now(), bus.tick() + 1, loop, std::move(afterTick) };
+        result = Result{};
+        result.stateDigest = STATE_DIGEST_SEED;
+        stopping.store(false);
+        bus.setTap(this);
+
+        // A tick's records may straddle a segment or block boundary, so group
+        // them across the whole trace. Compact segments hand out records only
+        // for the duration of the call, so the group holds copies.
+        std::vector<TraceRecord> group;
+        trace.forEach([this, &group](const TraceRecord& record) {
+            if (!group.empty() && record.tick != group.front().tick) {
+                replayTick(group);
+                group.clear();
+            }
+            group.push_back(record);
+            // Nothing after stop() is replayed, so don't decode it either
+            return !stopping.load(std::memory_order_relaxed);
+        });
+        if (!group.empty()) {
+            replayTick(group);
+        }
+        // Quiet ticks after the last recorded message, so the digest covers
+        // every tick the live run folded
+        while (bus.tick() < trace.lastTick() && !stopping.load(std::memory_order_relaxed)) {
+            step();
+        }
+
+        bus.setTap(nullptr);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - pace.start).count();
+        return result;
+    }
+
+    // Any thread; run() returns after the current tick
+    void stop() { stopping.store(true); }
+
+    // Compare each outbound message with the next one recorded for this tick
+    void onMessage(const Message& msg, TapPoint point, uint32_t tick) override {
+        if (point != TapPoint::OUTBOUND) {
+            return;
+        }
+        if (nextExpected >= expected.size() || !sameMessage(expected[nextExpected].msg, msg) ||
+            expected[nextExpected].tick != tick) {
+            if (reported++ < MAX_REPORTED) {
+                std::cerr << "[ReplayEngine] Tick " << tick << ": outbound message differs from the recording" << std::endl;
+            }
+            ++tickMismatches;
+        } else {
+            ++tickMatches;
+        }
+        ++nextExpected;
+    }
+
+private:
+    static constexpr uint64_t MAX_REPORTED = 10;
+
+    // Everything carried on the wire; enqueueNs is local timing and differs
+    static bool sameMessage(const Message& a, const Message& b) {
+        uint8_t left[MAX_FRAME_SIZE];
+        uint8_t right[MAX_FRAME_SIZE];
+        std::size_t leftSize = encodeFrame(a, left);
+        std::size_t rightSize = encodeFrame(b, right);
+        return a.flags == b.flags && leftSize == rightSize && std::memcmp(left, right, leftSize) == 0;
+    }
+
+    struct Pace {
+        double speed = 0;
+        std::chrono::milliseconds tickInterval{0};
+        std::chrono::steady_clock::time_point start;
+        uint32_t firstTick = 0;
+        BusLoop* loop = nullptr;
+        std::function<void()> afterTick;
+    };
+
+    void replayTick(std::span<const TraceRecord> records) {
+        uint32_t target = records.front().tick;
+        if (stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (target <= bus.tick()) {
+            // Out of order, or produced outside a tick; nothing to replay it into
+            result.mismatches += records.size();
+            return;
+        }
+
+        // Quiet ticks up to this one
+        while (bus.tick() + 1 < target && !stopping.load(std::memory_order_relaxed)) {
+            step();
+        }
+
+        for (const TraceRecord& record : records) {
+            if (record.point == TapPoint::INBOUND) {
+                bus.pushInbound(record.msg);
+                ++result.injected;
+            } else if (record.point == TapPoint::ANALOG) {
+                const AnalogSample& sample = record.msg.getAnalogSample();
+                bus.publishAnalog(sample.channel, sample.value);
+                ++result.injected;
+            } else {
+                expected.push_back(record);
+            }
+        }
+        step();
+    }
+
+    void waitForDeadline() {
+        if (pace.speed <= 0) {
+            if (pace.loop) {
+                pace.loop->runOnce(0);
+            }
+            return;
+        }
+
+        auto offset = std::chrono::duration<double, std::milli>(
+            static_cast<double>(pace.tickInterval.count()) * (bus.tick() + 1 - pace.firstTick) / pace.speed);
+        auto deadline = pace.start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+        for (auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now()) {
+            if (!pace.loop) {
+                std::this_thread::sleep_until(deadline);
+                break;
+            }
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            if (wait == 0) {
+                // Less than the loop's resolution left
+                std::this_thread::sleep_until(deadline);
+                break;
+            }
+            pace.loop->runOnce(static_cast<int>(wait));
+        }
+    }
+
+    void step() {
+        waitForDeadline();
+
+        tickMatches = 0;
+        tickMismatches = 0;
+        engine.tick();
+        ++result.ticks;
+        result.compared += tickMatches;
+        result.mismatches += tickMismatches;
+        if (nextExpected < expected.size()) {
+            // The recording emitted messages this run did not
+            result.mismatches += expected.size() - nextExpected;
+            if (reported++ < MAX_REPORTED) {
+                std::cerr << "[ReplayEngine] Tick " << bus.tick() << ": " << expected.size() - nextExpected
+                          << " recorded outbound messages were not reproduced" << std::endl;
+            }
+        }
+        expected.clear();
+        nextExpected = 0;
+
+        result.stateDigest = digestState(result.stateDigest, state);
+
+        if (pace.afterTick) {
+            pace.afterTick();
+        }
+    }
+
+    const TraceReader& trace;
+    MessageBus& bus;
+    tickEngine::TickEngine& engine;
+    const ControllerState& state;
+    std::atomic<bool> stopping{false};
+    Pace pace;
+    Result result;
+
+    // Outbound records of the tick being replayed, in recorded order
+    std::vector<TraceRecord> expected;
+    std::size_t nextExpected = 0;
+    uint64_t tickMatches = 0;
+    uint64_t tickMismatches = 0;
+    uint64_t reported = 0;
+};
+
+#endif // __linux__
@@ -0,0 +1,50 @@
+// state_export.hpp
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+#include "controller_core.hpp"
+#include "../bus/state_publisher.hpp"
+#include "../bus/symbol_table.hpp"
+
+// Copies ControllerState into the state feed after each tick. The
+// controller's phase goes under its own name as "phase", like a
+// StateTransition would; scram and subsystem status get a component each.
+// Subsystems keep no status of their own yet, so each reports the
+// controller's allSubsystemsOnline.
+//
+// Interns its names up front, so construct it before the tick loop starts.
+class StateExport {
+public:
+    StateExport(const char* controller, std::initializer_list<const char*> subsystemNames)
+        : controller(symbols().intern(controller)),
+          scram(symbols().intern("scram")),
+          allSubsystems(symbols().intern("subsystems")),
+          phase(symbols().intern("phase")),
+          engaged(symbols().intern("engaged")),
+          online(symbols().intern("online")) {
+        for (const char* name : subsystemNames) {
+            subsystems.push_back(symbols().intern(name));
+        }
+    }
+
+    // Unchanged values are filtered by the publisher, so this is cheap to
+    // call every tick
+    void update(StatePublisher& publisher, const ControllerState& state) const {
+        publisher.update(controller, phase, static_cast<int32_t>(state.phase));
+        publisher.update(scram, engaged, state.scramEngaged ? 1 : 0);
+        publisher.update(allSubsystems, online, state.allSubsystemsOnline ? 1 : 0);
+        for (SymbolId subsystem : subsystems) {
+            publisher.update(subsystem, online, state.allSubsystemsOnline ? 1 : 0);
+        }
+    }
+
+private:
+    SymbolId controller;
+    SymbolId scram;
+    SymbolId allSubsystems;
+    SymbolId phase;
+    SymbolId engaged;
+    SymbolId online;
+    std::vector<SymbolId> subsystems;
+};
@@ -1,12 +1,13 @@
 #pragma once
 #include <iostream>
 #include "controller_core.hpp"
+#include "../bus/message_bus.hpp"
 
 
 class PowerStateMachine {
 public:
-    PowerStateMachine(ControllerState& state)
-        : state(state) {}
+    PowerStateMachine(ControllerState& state, MessageBus& bus)
+        : state(state), bus(bus), sourceId(symbols().intern("power_state_machine")) {}
 
     void tickAdvance() {
         switch (state.phase) {
@@ -25,10 +26,9 @@ public:
     }
 
 private:
-    static constexpr uint8_t POWER_BUTTON_ID = 0;
-
     ControllerState& state;
     MessageBus& bus;
+    SymbolId sourceId;
 
     void handlePowerButton() {
         switch (state.phase) {
@@ -56,12 +56,8 @@ private:
         std::cout << std::endl;
     
         state.phase = next;
-        bus.emitOutbound({
-            .type = MessageType::STATE_TRANSITION,
-            .sourceId = POWER_BUTTON_ID,
-            .intValue = static_cast<int>(next),
-            .strValue = std::nullopt
-        });
+        bus.emitOutbound(Message::make(sourceId, NO_SYMBOL,
+            StateTransition{ static_cast<uint8_t>(next) }));
     }
    
     
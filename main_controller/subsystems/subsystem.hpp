@@ -1,9 +1,19 @@
 // subsystem.hpp
 #pragma once
 
+#include <span>
+#include "../../bus/message_types.hpp"
+
 class Subsystem {
 public:
     virtual void initialize() = 0;
     virtual void on_tick() = 0;
+
+    // Batch mode: one call per payload type per tick, in arrival order.
+    // Override only the payload types the subsystem cares about.
+    virtual void on_messages(std::span<const ButtonPress>) {}
+    virtual void on_messages(std::span<const StateTransition>) {}
+    virtual void on_messages(std::span<const AnalogSample>) {}
+
     virtual ~Subsystem() = default;
-};
\ No newline at end of file
+};
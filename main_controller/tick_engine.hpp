@@ -10,13 +10,18 @@ namespace tickEngine {
 
     class TickEngine {
     public:
-        TickEngine(ControllerState& state)
-            : state(state) {}
+        TickEngine(ControllerState& state, MessageBus& bus)
+            : state(state), bus(bus) {}
 
         void register_subsystem(Subsystem* subsystem) {
             subsystems.push_back(subsystem);
         }
 
+        // Deliver each tick's inbound messages to subsystems grouped by type
+        void set_batch_mode(bool enabled) {
+            batchMode = enabled;
+        }
+
         void initialize_all() {
             for (Subsystem* s : subsystems) {
                 s->initialize();
@@ -26,6 +31,13 @@ namespace tickEngine {
         void tick() {
             std::cout << "[tickEngine] Tick executed.\n";
 
+            // Publish last tick's traffic as this tick's stable inbound view
+            bus.swapBuffers();
+
+            if (batchMode) {
+                deliver_batches();
+            }
+
             for (Subsystem* s : subsystems) {
                 s->on_tick();
             }
@@ -33,7 +45,22 @@ namespace tickEngine {
 
     private:
         ControllerState& state;
+        MessageBus& bus;
         std::vector<Subsystem*> subsystems;
+        bool batchMode = false;
+
+        // One virtual call per (type, subsystem) instead of per message
+        void deliver_batches() {
+            const TypeBatches& batches = bus.partitionInbound();
+            batches.forEachBatch([this](auto batch) {
+                if (batch.empty()) {
+                    return;
+                }
+                for (Subsystem* s : subsystems) {
+                    s->on_messages(batch);
+                }
+            });
+        }
     };
 
 } // namespace tickEngine
\ No newline at end of file
@@ -120,6 +120,8 @@ int main(int argc, char* argv[]) {
         }
         configFile >> config;
         std::cout << "DEBUG: Configuration file loaded successfully" << std::endl;
+
+        ConfigHelper::internSymbols(config);
         
         // Initialize all named pipes from controller_pipes and phy_pipes sections
         std::cout << "[Main] Initializing named pipes..." << std::endl;
@@ -4,7 +4,7 @@
 #include <SDL2/SDL.h>
 
 PowerButton::PowerButton(int x, int y, int w, int h)
-    : rect{x, y, w, h}, isOn(false), lastClickTime(0) {}
+    : rect{x, y, w, h}, isOn(false), lastClickTime(0), pin(symbols().intern("MASTER")) {}
 
 void PowerButton::handleClick(int mouseX, int mouseY) {
     Uint32 now = SDL_GetTicks();
@@ -14,7 +14,7 @@ void PowerButton::handleClick(int mouseX, int mouseY) {
         if (now - lastClickTime > 200) {
             isOn = !isOn;
             // Use the pipe name from configuration
-            emitPinState("MASTER", "phc_a_pins", isOn);
+            emitPinState(pin, "phc_a_pins", isOn);
             lastClickTime = now;
         }
     }
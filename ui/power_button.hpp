@@ -1,6 +1,7 @@
 // power_button.hpp
 #pragma once
 #include <SDL2/SDL.h>
+#include "../bus/symbol_table.hpp"
 
 class PowerButton {
 public:
@@ -12,4 +13,5 @@ private:
     SDL_Rect rect;
     bool isOn;
     Uint32 lastClickTime;
+    SymbolId pin;       // MASTER, interned once rather than per click
 };